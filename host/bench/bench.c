@@ -0,0 +1,284 @@
+// Microbenchmarks of the SDK independent modules, reporting the mean time per
+// call (ns/op) and the number of heap allocations per call.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "base_conversion.h"
+#include "bech32_encode_bytes.h"
+#include "cbor_tokenizer.h"
+#include "display_source.h"
+#include "global_state.h"
+#include "radix_address.h"
+#include "radix_resource_identifier.h"
+#include "segwit_addr.h"
+#include "sha256_hash.h"
+#include "stringify_bip32_path.h"
+#include "uint256.h"
+
+// Defined by `main.c` in the app, holds the scratch arena of the helpers.
+command_context_t global;
+
+// ======= ALLOCATION COUNTING ======================
+
+static unsigned long allocation_count;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+void __real_free(void *pointer);
+
+void *__wrap_malloc(size_t size) {
+    allocation_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocation_count++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    allocation_count++;
+    return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void *pointer) { __real_free(pointer); }
+
+// ======= HARNESS ======================
+
+#define TARGET_DURATION_NS 200000000ULL  // per benchmark
+
+typedef void (*bench_fn_t)(void);
+
+static volatile uint8_t sink;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void run(const char *name, bench_fn_t fn) {
+    // Calibrate the number of iterations to run for about TARGET_DURATION_NS.
+    uint64_t iterations = 1;
+    uint64_t elapsed = 0;
+    for (;;) {
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            fn();
+        }
+        elapsed = now_ns() - start;
+        if (elapsed >= TARGET_DURATION_NS / 10 || iterations >= (1ULL << 40)) {
+            break;
+        }
+        iterations *= 10;
+    }
+    iterations = iterations * TARGET_DURATION_NS / (elapsed ? elapsed : 1);
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    allocation_count = 0;
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    elapsed = now_ns() - start;
+
+    printf("%-36s %12.1f ns/op %10.2f allocs/op %12llu iterations\n", name,
+           (double)elapsed / iterations, (double)allocation_count / iterations,
+           (unsigned long long)iterations);
+}
+
+// ======= FIXTURES ======================
+
+static const uint8_t public_key[PUBLIC_KEY_COMPRESSEED_BYTE_COUNT] = {
+    0x02, 0x79, 0xbe, 0x66, 0x7e, 0xf9, 0xdc, 0xbb, 0xac, 0x55, 0xa0,
+    0x62, 0x95, 0xce, 0x87, 0x0b, 0x07, 0x02, 0x9b, 0xfc, 0xdb, 0x2d,
+    0xce, 0x28, 0xd9, 0x59, 0xf2, 0x81, 0x5b, 0x16, 0xf8, 0x17, 0x98,
+};
+
+static uint8_t amount[RADIX_AMOUNT_BYTE_COUNT];
+static radix_address_t address;
+static radix_resource_identifier_t rri;
+static uint32_t bip32_path[NUMBER_OF_BIP32_COMPONENTS_IN_PATH] = {
+    44 | 0x80000000, 536 | 0x80000000, 2 | 0x80000000, 1, 3,
+};
+
+static void setup(void) {
+    memset(amount, 0xff, sizeof(amount));  // UInt256 max, longest decimal string
+
+    address.is_mainnet = true;
+    address.bytes[0] = RADIX_ADDRESS_VERSION_BYTE;
+    memcpy(address.bytes + RADIX_ADDRESS_VERSION_DATA_LENGTH, public_key, sizeof(public_key));
+
+    const char *rri_string = "/JH1P8f3znbyrDj8F4RWpix7hRkgxqHjdW2fNnKpR3v6ufXnknor/XRD";
+    memcpy(rri.bytes, rri_string, strlen(rri_string));
+}
+
+// An array of maps `{"address": <34 bytes>, "amount": <33 bytes>}`, roughly
+// shaped like the particles of an atom.
+#define NUMBER_OF_CBOR_MAPS 16
+static uint8_t cbor_bytes[NUMBER_OF_CBOR_MAPS * 88 + 1];
+static uint16_t cbor_byte_count;
+
+static void append_cbor_text(const char *text) {
+    size_t length = strlen(text);
+    cbor_bytes[cbor_byte_count++] = 0x60 | (uint8_t)length;
+    memcpy(cbor_bytes + cbor_byte_count, text, length);
+    cbor_byte_count += length;
+}
+
+static void append_cbor_bytes(uint8_t length) {
+    cbor_bytes[cbor_byte_count++] = 0x58;
+    cbor_bytes[cbor_byte_count++] = length;
+    memset(cbor_bytes + cbor_byte_count, 0xab, length);
+    cbor_byte_count += length;
+}
+
+static void setup_cbor(void) {
+    cbor_bytes[cbor_byte_count++] = 0x80 | NUMBER_OF_CBOR_MAPS;
+    for (int i = 0; i < NUMBER_OF_CBOR_MAPS; i++) {
+        cbor_bytes[cbor_byte_count++] = 0xa2;
+        append_cbor_text("address");
+        append_cbor_bytes(RADIX_ADDRESS_BYTE_COUNT);
+        append_cbor_text("amount");
+        append_cbor_bytes(RADIX_AMOUNT_BYTE_COUNT + 1);
+    }
+}
+
+// ======= BENCHMARKS ======================
+
+static void bench_convert_byte_buffer_into_decimal(void) {
+    uint8_t copy[RADIX_AMOUNT_BYTE_COUNT];
+    char output[UINT256_DEC_STRING_MAX_LENGTH + 1];
+    memcpy(copy, amount, sizeof(copy));  // converted in place
+    convert_byte_buffer_into_decimal(copy, sizeof(copy), output);
+    sink = output[0];
+}
+
+static void bench_hexadecimal_string_from(void) {
+    char output[2 * PUBLIC_KEY_COMPRESSEED_BYTE_COUNT + 1];
+    hexadecimal_string_from((uint8_t *)public_key, sizeof(public_key), output);
+    sink = output[0];
+}
+
+static void bench_convert_bits(void) {
+    uint8_t output[MAX_INPUT_SIZE * 2];
+    size_t output_length = 0;
+    convert_bits(output, &output_length, 5, address.bytes, RADIX_ADDRESS_BYTE_COUNT, 8, 1);
+    sink = output[0];
+}
+
+static uint8_t five_bit_address[MAX_INPUT_SIZE * 2];
+static size_t five_bit_address_length;
+
+static void bench_bech32_encode(void) {
+    char output[RADIX_ADDRESS_BECH32_CHAR_COUNT_MAX + 1];
+    bech32_encode(output, "rdx", five_bit_address, five_bit_address_length);
+    sink = output[0];
+}
+
+static void bench_to_string_radix_address(void) {
+    char output[RADIX_ADDRESS_BECH32_CHAR_COUNT_MAX + 1];
+    to_string_radix_address(&address, output, sizeof(output));
+    sink = output[0];
+}
+
+// A window of the width of the display, 12 characters.
+#define WINDOW_LENGTH 12
+
+static void bench_render_window_hex(void) {
+    char output[WINDOW_LENGTH + 1];
+    display_source_t source = hex_display_source(public_key, sizeof(public_key));
+    render_display_source_window(&source, 20, WINDOW_LENGTH, output);
+    sink = output[0];
+}
+
+// Showing an address, which renders it whole.
+static void bench_render_window_radix_address(void) {
+    char output[WINDOW_LENGTH + 1];
+    display_source_t source = radix_address_display_source(&address);
+    render_display_source_window(&source, 20, WINDOW_LENGTH, output);
+    release_display_source_rendering();
+    sink = output[0];
+}
+
+// Seeking through an address shown, which copies out of its rendering.
+static void bench_seek_window_radix_address(void) {
+    static uint16_t offset;
+    char output[WINDOW_LENGTH + 1];
+    display_source_t source = radix_address_display_source(&address);
+    offset = (offset + 1) % 32;
+    render_display_source_window(&source, offset, WINDOW_LENGTH, output);
+    sink = output[0];
+}
+
+static void bench_stringify_bip32_path(void) {
+    char output[BIP32_PATH_STRING_MAX_LENGTH + 10];
+    stringify_bip32_path(bip32_path, NUMBER_OF_BIP32_COMPONENTS_IN_PATH, output);
+    sink = output[0];
+}
+
+static void bench_to_string_rri(void) {
+    char output[RADIX_RRI_STRING_LENGTH_MAX];
+    to_string_rri(&rri, output, sizeof(output), false);
+    sink = output[0];
+}
+
+static void bench_to_string_rri_symbol(void) {
+    char output[RADIX_RRI_STRING_LENGTH_MAX];
+    to_string_rri(&rri, output, sizeof(output), true);
+    sink = output[0];
+}
+
+static void bench_double_sha256_of_chunk(void) {
+    cx_sha256_t hasher;
+    uint8_t digest[HASH256_BYTE_COUNT];
+    cx_sha256_init(&hasher);
+    update_hash_and_maybe_finalize(G_io_apdu_buffer, MAX_CHUNK_SIZE, true, &hasher, digest);
+    sink = digest[0];
+}
+
+static void count_tokens(const cbor_token_t *token, void *context) {
+    (*(unsigned int *)context)++;
+}
+
+static void bench_cbor_tokenizer_feed(void) {
+    cbor_tokenizer_t tokenizer;
+    unsigned int number_of_tokens = 0;
+    cbor_tokenizer_init(&tokenizer);
+    for (uint16_t offset = 0; offset < cbor_byte_count; offset += MAX_CHUNK_SIZE) {
+        uint16_t remaining = cbor_byte_count - offset;
+        cbor_tokenizer_feed(&tokenizer, cbor_bytes + offset,
+                            remaining < MAX_CHUNK_SIZE ? remaining : MAX_CHUNK_SIZE,
+                            count_tokens, &number_of_tokens);
+    }
+    sink = (uint8_t)number_of_tokens;
+}
+
+int main(void) {
+    setup();
+    setup_cbor();
+    convert_bits(five_bit_address, &five_bit_address_length, 5, address.bytes,
+                 RADIX_ADDRESS_BYTE_COUNT, 8, 1);
+
+    run("convert_byte_buffer_into_decimal", bench_convert_byte_buffer_into_decimal);
+    run("hexadecimal_string_from", bench_hexadecimal_string_from);
+    run("convert_bits", bench_convert_bits);
+    run("bech32_encode", bench_bech32_encode);
+    run("to_string_radix_address", bench_to_string_radix_address);
+    run("render_display_source_window (hex)", bench_render_window_hex);
+    run("render_display_source_window (address)", bench_render_window_radix_address);
+    run("render_display_source_window (seek)", bench_seek_window_radix_address);
+    release_display_source_rendering();
+    run("stringify_bip32_path", bench_stringify_bip32_path);
+    run("to_string_rri", bench_to_string_rri);
+    run("to_string_rri (symbol)", bench_to_string_rri_symbol);
+    run("update_hash_and_maybe_finalize", bench_double_sha256_of_chunk);
+    run("cbor_tokenizer_feed (1.4 KB)", bench_cbor_tokenizer_feed);
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Software implementation of the subset of the BOLOS `cx` API used on host.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cx.h"
+#include "os.h"
+#include "os_io_seproxyhal.h"
+
+unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+void host_throw(exception_t e) {
+    fprintf(stderr, "THROW(0x%04x)\n", e);
+    abort();
+}
+
+#define CX_SHA256 3
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void load_state(const cx_sha256_t *ctx, uint32_t *state) {
+    for (int i = 0; i < 8; i++) {
+        state[i] = U4BE(ctx->acc, 4 * i);
+    }
+}
+
+static void store_state(cx_sha256_t *ctx, const uint32_t *state) {
+    for (int i = 0; i < 8; i++) {
+        ctx->acc[4 * i + 0] = state[i] >> 24;
+        ctx->acc[4 * i + 1] = state[i] >> 16;
+        ctx->acc[4 * i + 2] = state[i] >> 8;
+        ctx->acc[4 * i + 3] = state[i];
+    }
+}
+
+static void sha256_block(cx_sha256_t *ctx, const unsigned char *block) {
+    uint32_t w[64], s[8], h[8];
+    for (int i = 0; i < 16; i++) {
+        w[i] = U4BE(block, 4 * i);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    load_state(ctx, h);
+    memcpy(s, h, sizeof(s));
+    for (int i = 0; i < 64; i++) {
+        uint32_t S1 = ROTR(s[4], 6) ^ ROTR(s[4], 11) ^ ROTR(s[4], 25);
+        uint32_t ch = (s[4] & s[5]) ^ (~s[4] & s[6]);
+        uint32_t t1 = s[7] + S1 + ch + sha256_k[i] + w[i];
+        uint32_t S0 = ROTR(s[0], 2) ^ ROTR(s[0], 13) ^ ROTR(s[0], 22);
+        uint32_t maj = (s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]);
+        uint32_t t2 = S0 + maj;
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = s[3] + t1;
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = t1 + t2;
+    }
+    for (int i = 0; i < 8; i++) {
+        h[i] += s[i];
+    }
+    store_state(ctx, h);
+    ctx->header.counter++;
+}
+
+int cx_sha256_init(cx_sha256_t *hash) {
+    memset(hash, 0, sizeof(*hash));
+    hash->header.algo = CX_SHA256;
+    store_state(hash, sha256_iv);
+    return CX_SHA256;
+}
+
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len) {
+    cx_sha256_t *ctx = (cx_sha256_t *)hash;
+
+    while (len > 0) {
+        unsigned int n = 64 - ctx->blen;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(ctx->block + ctx->blen, in, n);
+        ctx->blen += n;
+        in += n;
+        len -= n;
+        if (ctx->blen == 64) {
+            sha256_block(ctx, ctx->block);
+            ctx->blen = 0;
+        }
+    }
+
+    if (!(mode & CX_LAST)) {
+        return 0;
+    }
+    if (out_len < CX_SHA256_SIZE) {
+        THROW(INVALID_PARAMETER);
+    }
+
+    uint64_t bit_count = ((uint64_t)ctx->header.counter * 64 + ctx->blen) * 8;
+    ctx->block[ctx->blen++] = 0x80;
+    if (ctx->blen > 56) {
+        memset(ctx->block + ctx->blen, 0, 64 - ctx->blen);
+        sha256_block(ctx, ctx->block);
+        ctx->blen = 0;
+    }
+    memset(ctx->block + ctx->blen, 0, 56 - ctx->blen);
+    for (int i = 0; i < 8; i++) {
+        ctx->block[56 + i] = bit_count >> (56 - 8 * i);
+    }
+    sha256_block(ctx, ctx->block);
+    memcpy(out, ctx->acc, CX_SHA256_SIZE);
+    return CX_SHA256_SIZE;
+}
+
+int cx_hash_sha256(const unsigned char *in, unsigned int len, unsigned char *out,
+                   unsigned int out_len) {
+    cx_sha256_t ctx;
+    cx_sha256_init(&ctx);
+    return cx_hash(&ctx.header, CX_LAST, in, len, out, out_len);
+}
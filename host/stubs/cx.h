@@ -0,0 +1,52 @@
+// Host stand-in for the BOLOS SDK `cx.h`. Hashing is backed by a software
+// implementation (see `cx.c`), the ECC types are only declared so that headers
+// mentioning them compile.
+#ifndef HOST_STUB_CX_H
+#define HOST_STUB_CX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CX_LAST (1 << 0)
+
+#define CX_SHA256_SIZE 32
+
+typedef enum {
+    CX_CURVE_NONE,
+    CX_CURVE_SECP256K1,
+} cx_curve_t;
+#define CX_CURVE_256K1 CX_CURVE_SECP256K1
+
+typedef struct {
+    cx_curve_t curve;
+    size_t W_len;
+    unsigned char W[65];
+} cx_ecfp_public_key_t;
+
+typedef struct {
+    cx_curve_t curve;
+    size_t d_len;
+    unsigned char d[32];
+} cx_ecfp_private_key_t;
+
+typedef struct {
+    unsigned int algo;
+    unsigned int counter;
+} cx_hash_t;
+
+typedef struct {
+    cx_hash_t header;
+    unsigned int blen;
+    unsigned char block[64];
+    unsigned char acc[8 * 4];
+} cx_sha256_t;
+
+int cx_sha256_init(cx_sha256_t *hash);
+
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len);
+
+int cx_hash_sha256(const unsigned char *in, unsigned int len, unsigned char *out,
+                   unsigned int out_len);
+
+#endif
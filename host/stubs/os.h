@@ -0,0 +1,57 @@
+// Host (x86-64 Linux) stand-in for the BOLOS SDK `os.h`, only providing what
+// the SDK independent modules of the app (`src/common`,
+// `src/sign_tx/helpers`) need to compile and run on a development machine.
+#ifndef HOST_STUB_OS_H
+#define HOST_STUB_OS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define os_memcpy memcpy
+#define os_memmove memmove
+#define os_memset memset
+#define os_memcmp memcmp
+
+#define SPRINTF sprintf
+
+#ifndef PRINTF
+#define PRINTF(...)
+#endif
+
+#define U4BE(buf, off)                                          \
+    (((uint32_t)(buf)[(off)] << 24) | ((uint32_t)(buf)[(off) + 1] << 16) | \
+     ((uint32_t)(buf)[(off) + 2] << 8) | (uint32_t)(buf)[(off) + 3])
+#define U4LE(buf, off)                                          \
+    (((uint32_t)(buf)[(off) + 3] << 24) | ((uint32_t)(buf)[(off) + 2] << 16) | \
+     ((uint32_t)(buf)[(off) + 1] << 8) | (uint32_t)(buf)[(off)])
+
+// Exception codes, same values as the SDK.
+#define EXCEPTION 1
+#define INVALID_PARAMETER 2
+#define EXCEPTION_OVERFLOW 3
+#define EXCEPTION_SECURITY 4
+#define INVALID_CRC 5
+#define INVALID_CHECKSUM 6
+#define INVALID_COUNTER 7
+#define NOT_SUPPORTED 8
+#define INVALID_STATE 9
+#define TIMEOUT 10
+#define EXCEPTION_PIC 11
+#define EXCEPTION_APPEXIT 12
+#define EXCEPTION_IO_OVERFLOW 13
+#define EXCEPTION_IO_HEADER 14
+#define EXCEPTION_IO_STATE 15
+#define EXCEPTION_IO_RESET 16
+#define EXCEPTION_CXPORT 17
+#define EXCEPTION_SYSTEM 18
+
+typedef unsigned short exception_t;
+
+// There is no exception handling on host, a THROW terminates the process.
+void host_throw(exception_t e) __attribute__((noreturn));
+#define THROW(x) host_throw(x)
+
+#endif
@@ -0,0 +1,16 @@
+// Host stand-in for the BOLOS SDK `os_io_seproxyhal.h`.
+#ifndef HOST_STUB_OS_IO_SEPROXYHAL_H
+#define HOST_STUB_OS_IO_SEPROXYHAL_H
+
+#include "os.h"
+
+#define IO_APDU_BUFFER_SIZE (5 + 255)
+extern unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+typedef struct {
+    unsigned int unused;
+} ux_state_t;
+
+static inline void io_seproxyhal_io_heartbeat(void) {}
+
+#endif
@@ -0,0 +1,4 @@
+// Host stand-in for the BOLOS SDK `seproxyhal_protocol.h`, nothing needed.
+#ifndef HOST_STUB_SEPROXYHAL_PROTOCOL_H
+#define HOST_STUB_SEPROXYHAL_PROTOCOL_H
+#endif
@@ -0,0 +1,644 @@
+// Known-answer tests of the SDK independent modules, run on the host. Every
+// failed check is reported with its line, the process fails if any test did.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atom_parser.h"
+#include "cbor_tokenizer.h"
+#include "display_source.h"
+#include "global_state.h"
+#include "input_chain.h"
+#include "rri_table.h"
+#include "scratch.h"
+#include "uint256.h"
+
+// Defined by `main.c` in the app, holds the scratch arena of the helpers.
+command_context_t global;
+
+// ======= HARNESS ======================
+
+typedef void (*test_fn_t)(void);
+
+static unsigned int number_of_failed_checks;
+
+#define CHECK(condition)                                                  \
+    do {                                                                  \
+        if (!(condition)) {                                               \
+            printf("    %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            number_of_failed_checks++;                                    \
+        }                                                                 \
+    } while (0)
+
+static unsigned int number_of_failed_tests;
+
+static void run(const char *name, test_fn_t fn) {
+    number_of_failed_checks = 0;
+    fn();
+    printf("%-52s %s\n", name, number_of_failed_checks ? "FAILED" : "ok");
+    if (number_of_failed_checks) {
+        number_of_failed_tests++;
+    }
+}
+
+// ======= CBOR BUILDER ======================
+
+typedef struct {
+    uint8_t bytes[2048];
+    uint16_t length;
+} cbor_buffer_t;
+
+static void append_header(cbor_buffer_t *buffer, uint8_t major_type, uint32_t argument) {
+    uint8_t initial_byte = major_type << 5;
+    if (argument < 24) {
+        buffer->bytes[buffer->length++] = initial_byte | argument;
+    } else if (argument <= 0xFF) {
+        buffer->bytes[buffer->length++] = initial_byte | 24;
+        buffer->bytes[buffer->length++] = argument;
+    } else {
+        buffer->bytes[buffer->length++] = initial_byte | 25;
+        buffer->bytes[buffer->length++] = argument >> 8;
+        buffer->bytes[buffer->length++] = argument & 0xFF;
+    }
+}
+
+static void append_text(cbor_buffer_t *buffer, const char *text) {
+    size_t length = strlen(text);
+    append_header(buffer, CBOR_MAJOR_TYPE_TEXT_STRING, length);
+    memcpy(buffer->bytes + buffer->length, text, length);
+    buffer->length += length;
+}
+
+// A DSON byte string, `prefix` followed by `byte_count` bytes of `bytes`.
+static void append_dson_bytes(cbor_buffer_t *buffer, uint8_t prefix, const void *bytes, uint8_t byte_count) {
+    append_header(buffer, CBOR_MAJOR_TYPE_BYTE_STRING, DSON_PREFIX_BYTE_COUNT + byte_count);
+    buffer->bytes[buffer->length++] = prefix;
+    memcpy(buffer->bytes + buffer->length, bytes, byte_count);
+    buffer->length += byte_count;
+}
+
+// ======= CBOR TOKENIZER ======================
+
+// Renders the tokens as text, joining the fragments of each string, so that
+// the trace does not depend on where the input was split.
+typedef struct {
+    char text[512];
+    size_t length;
+    uint32_t next_fragment_offset;
+    bool has_fragment_gap;
+} token_trace_t;
+
+static void trace_token(const cbor_token_t *token, void *context) {
+    token_trace_t *trace = (token_trace_t *) context;
+    char *end = trace->text + trace->length;
+    size_t room = sizeof(trace->text) - trace->length;
+    int written = 0;
+
+    switch (token->kind) {
+        case CBOR_TOKEN_SCALAR:
+            written = snprintf(end, room, "%s%d:%d=%llu ", token->is_map_key ? "k" : "",
+                               token->major_type, token->depth, (unsigned long long) token->argument);
+            break;
+        case CBOR_TOKEN_CONTAINER_START:
+            written = snprintf(end, room, "%s%d:%d%s%llu ", token->is_map_key ? "k" : "",
+                               token->major_type, token->depth, token->is_indefinite_length ? "[_" : "[",
+                               (unsigned long long) token->argument);
+            break;
+        case CBOR_TOKEN_CONTAINER_END:
+            written = snprintf(end, room, "]%d:%d ", token->major_type, token->depth);
+            break;
+        case CBOR_TOKEN_STRING_FRAGMENT:
+            if (token->fragment_offset != trace->next_fragment_offset) {
+                trace->has_fragment_gap = true;
+            }
+            if (token->fragment_offset == 0) {
+                written = snprintf(end, room, "%s%d:%d\"", token->is_map_key ? "k" : "",
+                                   token->major_type, token->depth);
+            }
+            for (uint16_t i = 0; i < token->fragment_length; ++i) {
+                written += snprintf(end + written, room - written, "%02x", token->fragment[i]);
+            }
+            if (token->is_last_fragment) {
+                written += snprintf(end + written, room - written, "\" ");
+                trace->next_fragment_offset = 0;
+            } else {
+                trace->next_fragment_offset = token->fragment_offset + token->fragment_length;
+            }
+            break;
+    }
+    trace->length += written;
+}
+
+// Feeds `bytes` split in two at `split`, returning false if the tokenizer
+// rejects them.
+static bool tokenize(const uint8_t *bytes, uint16_t byte_count, uint16_t split, token_trace_t *trace, bool *is_done) {
+    cbor_tokenizer_t tokenizer;
+    memset(trace, 0, sizeof(token_trace_t));
+    cbor_tokenizer_init(&tokenizer);
+    bool is_valid = cbor_tokenizer_feed(&tokenizer, bytes, split, trace_token, trace) &&
+        cbor_tokenizer_feed(&tokenizer, bytes + split, byte_count - split, trace_token, trace);
+    *is_done = cbor_tokenizer_is_done(&tokenizer);
+    return is_valid;
+}
+
+// `{"ab": [1, -2, h'0102', {}], "c": [_ true, 1000], "d": 4294967296}`
+static const uint8_t cbor_document[] = {
+    0xa3,
+    0x62, 'a', 'b', 0x84, 0x01, 0x21, 0x42, 0x01, 0x02, 0xa0,
+    0x61, 'c', 0x9f, 0xf5, 0x19, 0x03, 0xe8, 0xff,
+    0x61, 'd', 0x1b, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const char cbor_document_trace[] =
+    "5:0[3 "
+    "k3:1\"6162\" 4:1[4 0:2=1 1:2=1 2:2\"0102\" 5:2[0 ]5:2 ]4:1 "
+    "k3:1\"63\" 4:1[_0 7:2=21 0:2=1000 ]4:1 "
+    "k3:1\"64\" 0:1=4294967296 "
+    "]5:0 ";
+
+static void test_cbor_tokenizer_known_answer(void) {
+    token_trace_t trace;
+    bool is_done;
+    CHECK(tokenize(cbor_document, sizeof(cbor_document), sizeof(cbor_document), &trace, &is_done));
+    CHECK(is_done);
+    CHECK(strcmp(trace.text, cbor_document_trace) == 0);
+}
+
+static void test_cbor_tokenizer_split_at_every_offset(void) {
+    for (uint16_t split = 0; split <= sizeof(cbor_document); ++split) {
+        token_trace_t trace;
+        bool is_done;
+        CHECK(tokenize(cbor_document, sizeof(cbor_document), split, &trace, &is_done));
+        CHECK(is_done);
+        CHECK(!trace.has_fragment_gap);
+        CHECK(strcmp(trace.text, cbor_document_trace) == 0);
+    }
+}
+
+typedef struct {
+    const char *name;
+    uint8_t bytes[16];
+    uint8_t byte_count;
+} malformed_cbor_t;
+
+static const malformed_cbor_t malformed_cbor[] = {
+    // 2^63 pairs, doubling the count would wrap to 0.
+    {"map count wrapping when doubled", {0xbb, 0x80, 0, 0, 0, 0, 0, 0, 0}, 9},
+    {"map of 32768 pairs", {0xb9, 0x80, 0x00}, 3},
+    {"array of 65536 items", {0x9a, 0x00, 0x01, 0x00, 0x00}, 5},
+    {"string longer than 4 GB", {0x5b, 0, 0, 0, 0x01, 0, 0, 0, 0}, 9},
+    {"reserved additional info", {0x1c}, 1},
+    {"indefinite length integer", {0x1f}, 1},
+    {"indefinite length string", {0x5f, 0x41, 0x00, 0xff}, 4},
+    {"break outside of a container", {0xff}, 1},
+    {"break in a definite length array", {0x81, 0xff}, 2},
+    {"break after a key without value", {0xbf, 0x01, 0xff}, 3},
+    {"nesting deeper than the maximum", {0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x00}, 10},
+    {"trailing bytes", {0x01, 0x02}, 2},
+};
+
+static void test_cbor_tokenizer_rejects_malformed_headers(void) {
+    for (size_t i = 0; i < sizeof(malformed_cbor) / sizeof(malformed_cbor[0]); ++i) {
+        const malformed_cbor_t *malformed = &malformed_cbor[i];
+        for (uint16_t split = 0; split <= malformed->byte_count; ++split) {
+            token_trace_t trace;
+            bool is_done;
+            if (tokenize(malformed->bytes, malformed->byte_count, split, &trace, &is_done)) {
+                printf("    accepted: %s (split at %u)\n", malformed->name, split);
+                CHECK(false);
+            }
+        }
+    }
+}
+
+static void test_cbor_tokenizer_accepts_largest_counts(void) {
+    static const uint8_t largest_map[] = {0xb9, 0x7f, 0xff};
+    static const uint8_t largest_array[] = {0x99, 0xff, 0xff};
+    static const uint8_t deepest_nesting[] = {0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x00};
+    token_trace_t trace;
+    bool is_done;
+
+    CHECK(tokenize(largest_map, sizeof(largest_map), 0, &trace, &is_done));
+    CHECK(strcmp(trace.text, "5:0[32767 ") == 0);
+    CHECK(!is_done);
+
+    CHECK(tokenize(largest_array, sizeof(largest_array), 0, &trace, &is_done));
+    CHECK(strcmp(trace.text, "4:0[65535 ") == 0);
+    CHECK(!is_done);
+
+    CHECK(tokenize(deepest_nesting, sizeof(deepest_nesting), 0, &trace, &is_done));
+    CHECK(is_done);
+}
+
+// ======= ATOM PARSER ======================
+
+#define MAX_NUMBER_OF_PARSED_TRANSFERS 4
+
+static transfer_t parsed_transfers[MAX_NUMBER_OF_PARSED_TRANSFERS];
+static uint8_t number_of_parsed_transfers;
+
+static status_word_t collect_transfer(transfer_t *transfer) {
+    if (number_of_parsed_transfers == MAX_NUMBER_OF_PARSED_TRANSFERS) {
+        return SW_CAPACITY_EXCEEDED;
+    }
+    parsed_transfers[number_of_parsed_transfers++] = *transfer;
+    return SW_OK;
+}
+
+// A spun particle map `{"particle": {...}, "spin": 1}`, the particle holding
+// a token definition reference of `rri` and, for transfers, address and
+// amount.
+static void append_spun_particle(cbor_buffer_t *atom, const char *serializer, const char *rri, uint8_t amount) {
+    bool is_transfer = strcmp(serializer, "radix.particles.transferrable_tokens") == 0;
+    uint8_t address[RADIX_ADDRESS_BYTE_COUNT];
+    uint8_t amount_bytes[RADIX_AMOUNT_BYTE_COUNT] = {0};
+    memset(address, amount, sizeof(address));
+    amount_bytes[RADIX_AMOUNT_BYTE_COUNT - 1] = amount;
+
+    append_header(atom, CBOR_MAJOR_TYPE_MAP, 2);
+    append_text(atom, "particle");
+    append_header(atom, CBOR_MAJOR_TYPE_MAP, is_transfer ? 4 : 2);
+    if (is_transfer) {
+        append_text(atom, "address");
+        append_dson_bytes(atom, DSON_PREFIX_ADDRESS, address, sizeof(address));
+        append_text(atom, "amount");
+        append_dson_bytes(atom, DSON_PREFIX_UINT256, amount_bytes, sizeof(amount_bytes));
+    }
+    append_text(atom, "serializer");
+    append_text(atom, serializer);
+    append_text(atom, "tokenDefinitionReference");
+    append_dson_bytes(atom, DSON_PREFIX_RRI, rri, strlen(rri));
+    append_text(atom, "spin");
+    append_header(atom, CBOR_MAJOR_TYPE_UNSIGNED_INTEGER, 1);
+}
+
+// `{"particleGroups": [{"particles": [...]}]}` with a token definition for
+// each of more distinct tokens than the RRI table holds, followed by two
+// transfers of a single token.
+static void build_atom(cbor_buffer_t *atom) {
+    memset(atom, 0, sizeof(cbor_buffer_t));
+    append_header(atom, CBOR_MAJOR_TYPE_MAP, 1);
+    append_text(atom, "particleGroups");
+    append_header(atom, CBOR_MAJOR_TYPE_ARRAY, 1);
+    append_header(atom, CBOR_MAJOR_TYPE_MAP, 1);
+    append_text(atom, "particles");
+    append_header(atom, CBOR_MAJOR_TYPE_ARRAY, MAX_NUMBER_OF_INTERNED_RRIS + 3);
+    for (uint8_t i = 0; i <= MAX_NUMBER_OF_INTERNED_RRIS; ++i) {
+        char rri[] = "/JH1P8f3znbyrDj8F4RWpix7hRkgxqHjdW2fNnKpR3v6ufXnknor/TOKEN0";
+        rri[strlen(rri) - 1] += i;
+        append_spun_particle(atom, "radix.particles.mutable_supply_token_definition", rri, 0);
+    }
+    append_spun_particle(atom, "radix.particles.transferrable_tokens",
+                         "/JH1P8f3znbyrDj8F4RWpix7hRkgxqHjdW2fNnKpR3v6ufXnknor/XRD", 7);
+    append_spun_particle(atom, "radix.particles.transferrable_tokens",
+                         "/JH1P8f3znbyrDj8F4RWpix7hRkgxqHjdW2fNnKpR3v6ufXnknor/XRD", 9);
+}
+
+static atom_parser_t parser;
+
+// Parses `atom` split in two at `split`.
+static status_word_t parse_atom(const cbor_buffer_t *atom, uint16_t split) {
+    number_of_parsed_transfers = 0;
+    atom_parser_init(&parser, true);
+    status_word_t sw = atom_parser_feed(&parser, atom->bytes, split, collect_transfer);
+    if (sw != SW_OK) {
+        return sw;
+    }
+    return atom_parser_feed(&parser, atom->bytes + split, atom->length - split, collect_transfer);
+}
+
+static void check_parsed_transfers(void) {
+    CHECK(atom_parser_is_done(&parser));
+    CHECK(number_of_parsed_transfers == 2);
+    // Only the token of the transfers is interned.
+    CHECK(parser.rri_table.number_of_rris == 1);
+
+    for (uint8_t i = 0; i < number_of_parsed_transfers && i < 2; ++i) {
+        transfer_t *transfer = &parsed_transfers[i];
+        uint8_t amount = i == 0 ? 7 : 9;
+        CHECK(transfer->has_confirmed_serializer);
+        CHECK(transfer->address.is_mainnet);
+        CHECK(transfer->address.bytes[0] == amount && transfer->address.bytes[RADIX_ADDRESS_BYTE_COUNT - 1] == amount);
+        CHECK(transfer->amount.bytes[0] == 0 && transfer->amount.bytes[RADIX_AMOUNT_BYTE_COUNT - 1] == amount);
+        CHECK(transfer->token_definition_reference_index == 0);
+    }
+
+    uint8_t symbol_length = 0;
+    const char *symbol = interned_rri_symbol(&parser.rri_table, 0, &symbol_length);
+    CHECK(symbol_length == 3 && memcmp(symbol, "XRD", 3) == 0);
+}
+
+static void test_atom_parser_known_answer(void) {
+    cbor_buffer_t atom;
+    build_atom(&atom);
+    CHECK(parse_atom(&atom, atom.length) == SW_OK);
+    check_parsed_transfers();
+}
+
+static void test_atom_parser_split_at_every_offset(void) {
+    cbor_buffer_t atom;
+    build_atom(&atom);
+    for (uint16_t split = 0; split <= atom.length; ++split) {
+        CHECK(parse_atom(&atom, split) == SW_OK);
+        check_parsed_transfers();
+    }
+}
+
+static void test_atom_parser_rejects_transfer_without_token(void) {
+    cbor_buffer_t atom;
+    build_atom(&atom);
+    // Turn "tokenDefinitionReference" of the last transfer into a key the
+    // parser does not know.
+    const char key[] = "tokenDefinitionReference";
+    uint8_t *last_key = NULL;
+    for (uint16_t i = 0; i + sizeof(key) - 1 <= atom.length; ++i) {
+        if (memcmp(atom.bytes + i, key, sizeof(key) - 1) == 0) {
+            last_key = atom.bytes + i;
+        }
+    }
+    CHECK(last_key != NULL);
+    if (last_key) {
+        last_key[0] = 'x';
+    }
+    CHECK(parse_atom(&atom, atom.length) == SW_INVALID_PARAM);
+}
+
+// ======= UINT256 ======================
+
+static uint256_t uint256_of_byte(uint8_t fill) {
+    uint256_t value;
+    memset(value.bytes, fill, sizeof(value.bytes));
+    return value;
+}
+
+static void test_add_uint256(void) {
+    uint256_t one = uint256_of_byte(0);
+    one.bytes[RADIX_AMOUNT_BYTE_COUNT - 1] = 1;
+
+    // Carry through every byte.
+    uint256_t sum = uint256_of_byte(0xff);
+    sum.bytes[0] = 0x00;
+    CHECK(add_uint256(&sum, &one));
+    uint256_t expected = uint256_of_byte(0);
+    expected.bytes[0] = 0x01;
+    CHECK(memcmp(sum.bytes, expected.bytes, RADIX_AMOUNT_BYTE_COUNT) == 0);
+
+    // Largest sum which does not overflow.
+    sum = uint256_of_byte(0x80);
+    uint256_t addend = uint256_of_byte(0x7f);
+    CHECK(add_uint256(&sum, &addend));
+    expected = uint256_of_byte(0xff);
+    CHECK(memcmp(sum.bytes, expected.bytes, RADIX_AMOUNT_BYTE_COUNT) == 0);
+
+    // Max + 1 overflows, leaving the augend untouched.
+    CHECK(!add_uint256(&sum, &one));
+    CHECK(memcmp(sum.bytes, expected.bytes, RADIX_AMOUNT_BYTE_COUNT) == 0);
+
+    // Overflow out of the most significant byte only.
+    sum = uint256_of_byte(0);
+    sum.bytes[0] = 0x80;
+    addend = sum;
+    CHECK(!add_uint256(&sum, &addend));
+    CHECK(sum.bytes[0] == 0x80);
+
+    // Adding zero never overflows.
+    uint256_t zero = uint256_of_byte(0);
+    CHECK(add_uint256(&sum, &zero));
+}
+
+// ======= RRI TABLE ======================
+
+static status_word_t intern(rri_table_t *table, const char *rri, uint8_t *output_index) {
+    memcpy(rri_table_assembly_buffer(table), rri, strlen(rri));
+    return intern_assembled_rri(table, strlen(rri), output_index);
+}
+
+static void test_rri_table(void) {
+    rri_table_t table;
+    uint8_t index = 0xFF;
+    uint8_t symbol_length = 0;
+    memset(&table, 0, sizeof(table));
+
+    CHECK(intern(&table, "/JH1P/XRD", &index) == SW_OK);
+    CHECK(index == 0);
+    CHECK(intern(&table, "/JH1P/FOO", &index) == SW_OK);
+    CHECK(index == 1);
+    CHECK(intern(&table, "/JH1P/XRD", &index) == SW_OK);
+    CHECK(index == 0);
+    // Same symbol of another address is another token.
+    CHECK(intern(&table, "/9SBa/XRD", &index) == SW_OK);
+    CHECK(index == 2);
+    CHECK(table.number_of_rris == MAX_NUMBER_OF_INTERNED_RRIS);
+
+    const char *symbol = interned_rri_symbol(&table, 1, &symbol_length);
+    CHECK(symbol_length == 3 && memcmp(symbol, "FOO", 3) == 0);
+
+    // Full, but known tokens can still be referred to.
+    CHECK(intern(&table, "/JH1P/BAR", &index) == SW_CAPACITY_EXCEEDED);
+    CHECK(intern(&table, "/JH1P/FOO", &index) == SW_OK);
+    CHECK(index == 1);
+
+    static const char *invalid_rris[] = {"JH1P/XRD", "/JH1P/", "//XRD", "/JH1P", "/"};
+    for (size_t i = 0; i < sizeof(invalid_rris) / sizeof(invalid_rris[0]); ++i) {
+        CHECK(intern(&table, invalid_rris[i], &index) == SW_INVALID_PARAM);
+    }
+    CHECK(table.number_of_rris == MAX_NUMBER_OF_INTERNED_RRIS);
+}
+
+// ======= DISPLAY SOURCE ======================
+
+#define WINDOW_LENGTH 12
+
+static void test_display_source_rendering_is_kept_while_shown(void) {
+    radix_address_t address;
+    char expected[RADIX_ADDRESS_BECH32_CHAR_COUNT_MAX + 1];
+    char window[WINDOW_LENGTH + 1];
+
+    memset(&address, 0, sizeof(address));
+    address.is_mainnet = true;
+    address.bytes[0] = RADIX_ADDRESS_VERSION_BYTE;
+    address.bytes[1] = 0x02;
+    memset(address.bytes + 2, 0x5a, RADIX_ADDRESS_BYTE_COUNT - 2);
+    size_t length = to_string_radix_address(&address, expected, sizeof(expected));
+    CHECK(scratch_mark() == 0);
+
+    // Seeking through the value renders the same windows as rendering it whole.
+    display_source_t source = radix_address_display_source(&address);
+    for (uint16_t offset = 0; offset + WINDOW_LENGTH <= length; ++offset) {
+        CHECK(render_display_source_window(&source, offset, WINDOW_LENGTH, window) == length);
+        CHECK(memcmp(window, expected + offset, WINDOW_LENGTH) == 0 && window[WINDOW_LENGTH] == '\0');
+        CHECK(scratch_mark() > 0);  // the rendering is kept
+    }
+
+    // The rendering of another value at the same address is not reused once released.
+    release_display_source_rendering();
+    CHECK(scratch_mark() == 0);
+    address.is_mainnet = false;
+    char betanet_window[WINDOW_LENGTH + 1];
+    render_display_source_window(&source, 0, WINDOW_LENGTH, betanet_window);
+    CHECK(memcmp(betanet_window, expected, WINDOW_LENGTH) != 0);
+
+    // A reset of the arena, which zeroes it, drops the rendering.
+    scratch_reset();
+    render_display_source_window(&source, 0, WINDOW_LENGTH, window);
+    CHECK(strcmp(window, betanet_window) == 0);
+    release_display_source_rendering();
+    CHECK(scratch_mark() == 0);
+
+    // Hexadecimal values take nothing from the arena.
+    display_source_t hex = hex_display_source(address.bytes, 4);
+    CHECK(render_display_source_window(&hex, 2, WINDOW_LENGTH, window) == 8);
+    CHECK(strcmp(window, "025a5a") == 0);
+    CHECK(scratch_mark() == 0);
+}
+
+// ======= INPUT CHAIN ======================
+
+#define INS_CHAINED 0x16
+#define INS_OTHER 0x18
+#define MAX_CHAINED_INPUT_LENGTH 64
+
+static uint8_t chained_hash[HASH256_BYTE_COUNT];
+
+static void setup_chained_hash(void) {
+    for (uint8_t i = 0; i < HASH256_BYTE_COUNT; ++i) {
+        chained_hash[i] = 0xa0 + i;
+    }
+}
+
+// The BIP32 path (12 bytes) followed by a hash split across three APDUs,
+// 8, 10 and 14 bytes of it, the last APDU followed by 3 more bytes.
+static void test_input_chain_read_carries_split_hash(void) {
+    uint8_t first[BIP32_PATH_LEN + 8];
+    uint8_t middle[10];
+    uint8_t last[14 + 3];
+    uint8_t path[BIP32_PATH_LEN];
+    uint8_t hash[HASH256_BYTE_COUNT];
+    uint8_t *remaining = NULL;
+
+    memset(first, 0x11, BIP32_PATH_LEN);
+    memcpy(first + BIP32_PATH_LEN, chained_hash, 8);
+    memcpy(middle, chained_hash + 8, sizeof(middle));
+    memcpy(last, chained_hash + 18, 14);
+    memset(last + 14, 0x22, 3);
+
+    input_chain_reset();
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST, first, sizeof(first), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_is_first_chunk() && !input_chain_is_last_chunk());
+    CHECK(input_chain_read(path, BIP32_PATH_LEN));
+    CHECK(path[0] == 0x11 && path[BIP32_PATH_LEN - 1] == 0x11);
+    CHECK(!input_chain_read(hash, HASH256_BYTE_COUNT));
+    CHECK(!input_chain_is_fully_read());  // the carried bytes
+
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE, middle, sizeof(middle), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(!input_chain_is_first_chunk() && !input_chain_is_last_chunk());
+    CHECK(!input_chain_read(hash, HASH256_BYTE_COUNT));
+
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE | P1_CHAIN_LAST, last, sizeof(last), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_is_last_chunk());
+    CHECK(!input_chain_is_fully_read());
+    CHECK(input_chain_read(hash, HASH256_BYTE_COUNT));
+    CHECK(memcmp(hash, chained_hash, HASH256_BYTE_COUNT) == 0);
+    CHECK(input_chain_read_remaining(&remaining) == 3);
+    CHECK(remaining == last + 14);
+    CHECK(input_chain_is_fully_read());
+}
+
+// A hash read in one piece at each of the possible positions of the split.
+static void test_input_chain_read_at_every_split(void) {
+    for (uint8_t split = 0; split <= HASH256_BYTE_COUNT; ++split) {
+        uint8_t hash[HASH256_BYTE_COUNT];
+        bool is_first_read = false;
+        bool is_second_read = false;
+
+        input_chain_reset();
+        CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST, chained_hash, split, MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+        is_first_read = input_chain_read(hash, HASH256_BYTE_COUNT);
+        CHECK(is_first_read == (split == HASH256_BYTE_COUNT));
+        CHECK(input_chain_receive(
+            INS_CHAINED, P1_CHAIN_CONTINUE | P1_CHAIN_LAST,
+            chained_hash + split, HASH256_BYTE_COUNT - split, MAX_CHAINED_INPUT_LENGTH
+        ) == SW_OK);
+        if (!is_first_read) {
+            is_second_read = input_chain_read(hash, HASH256_BYTE_COUNT);
+        }
+        CHECK(is_first_read || is_second_read);
+        CHECK(memcmp(hash, chained_hash, HASH256_BYTE_COUNT) == 0);
+        CHECK(input_chain_is_fully_read());
+    }
+}
+
+static void test_input_chain_rejects_out_of_order_flags(void) {
+    uint8_t data[4] = {0};
+
+    input_chain_reset();
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+    CHECK(input_chain_receive(INS_CHAINED, 0x00, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST | P1_CHAIN_CONTINUE, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_LAST, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+
+    // Continuing the chain of another command.
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_receive(INS_OTHER, P1_CHAIN_CONTINUE, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+    // The failed continuation closed the chain.
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+
+    // Continuing a closed chain.
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST | P1_CHAIN_LAST, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+
+    // Exceeding the total length.
+    uint8_t chunk[MAX_CHAINED_INPUT_LENGTH / 2];
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST, chunk, sizeof(chunk), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE, chunk, sizeof(chunk), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE | P1_CHAIN_LAST, chunk, 1, MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+}
+
+// The dispatcher once reset the chain before every APDU, which made every
+// `P1_CHAIN_CONTINUE` fail. A chain must survive between the APDUs of its
+// command, with nothing but `input_chain_receive` called in between, and any
+// reset in between must make the continuation fail rather than start over.
+static void test_input_chain_stray_reset(void) {
+    uint8_t data[HASH256_BYTE_COUNT / 2] = {0};
+    uint8_t hash[HASH256_BYTE_COUNT];
+
+    input_chain_reset();
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(!input_chain_read(hash, HASH256_BYTE_COUNT));
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_read(hash, HASH256_BYTE_COUNT));
+
+    input_chain_reset();
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_CONTINUE, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_INVALID_PARAM);
+    CHECK(!input_chain_is_first_chunk());
+
+    // A new first APDU starts over, dropping the carry of the previous chain.
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST, data, sizeof(data), MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(!input_chain_read(hash, HASH256_BYTE_COUNT));
+    CHECK(input_chain_receive(INS_CHAINED, P1_CHAIN_FIRST | P1_CHAIN_LAST, chained_hash, HASH256_BYTE_COUNT, MAX_CHAINED_INPUT_LENGTH) == SW_OK);
+    CHECK(input_chain_read(hash, HASH256_BYTE_COUNT));
+    CHECK(memcmp(hash, chained_hash, HASH256_BYTE_COUNT) == 0);
+}
+
+int main(void) {
+    setup_chained_hash();
+
+    run("cbor_tokenizer (known answer)", test_cbor_tokenizer_known_answer);
+    run("cbor_tokenizer (split at every offset)", test_cbor_tokenizer_split_at_every_offset);
+    run("cbor_tokenizer (malformed headers)", test_cbor_tokenizer_rejects_malformed_headers);
+    run("cbor_tokenizer (largest counts)", test_cbor_tokenizer_accepts_largest_counts);
+    run("atom_parser (known answer)", test_atom_parser_known_answer);
+    run("atom_parser (split at every offset)", test_atom_parser_split_at_every_offset);
+    run("atom_parser (transfer without token)", test_atom_parser_rejects_transfer_without_token);
+    run("add_uint256", test_add_uint256);
+    run("rri_table", test_rri_table);
+    run("display_source (rendering kept while shown)", test_display_source_rendering_is_kept_while_shown);
+    run("input_chain_read (split hash)", test_input_chain_read_carries_split_hash);
+    run("input_chain_read (split at every offset)", test_input_chain_read_at_every_split);
+    run("input_chain_receive (out of order flags)", test_input_chain_rejects_out_of_order_flags);
+    run("input_chain (stray reset)", test_input_chain_stray_reset);
+
+    printf("%u test(s) failed\n", number_of_failed_tests);
+    return number_of_failed_tests ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -1,5 +1,6 @@
 #include "base_conversion.h"
 #include "os.h"
+#include "scratch.h"
 
 // Divide "number" of length "length" by "divisor" in place, returning remainder
 static uint8_t divmod(uint8_t *number, uint16_t length, uint8_t divisor) {
@@ -86,7 +87,11 @@ uint16_t hexadecimal_string_from(
     int byte_count, 
     char *output_buffer
 ) {
-	uint8_t copy[byte_count];
+    // The conversion consumes its input.
+    scratch_mark_t mark = scratch_mark();
+    uint8_t *copy = scratch_alloc(byte_count);
     os_memcpy(copy, bytes, byte_count);
-	return convert_byte_buffer_into_hexadecimal(copy, byte_count, output_buffer);
+    uint16_t length = convert_byte_buffer_into_hexadecimal(copy, byte_count, output_buffer);
+    scratch_release(mark);
+    return length;
 }
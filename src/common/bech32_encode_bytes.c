@@ -19,6 +19,7 @@
 #include "bech32_encode_bytes.h"
 #include "os.h"
 #include "segwit_addr.h"
+#include "scratch.h"
 
 bool address_from_network_and_bytes(
     bool is_mainnet, // else betanet
@@ -38,7 +39,8 @@ bool address_from_network_and_bytes(
     }
 
     size_t hrplen = 3;
-    char hrp[hrplen];
+    char hrp[hrplen + 1]; // +1 for null, `bech32_encode` expects a null terminated `hrp`
+    hrp[hrplen] = '\0';
     
     if (is_mainnet) {
         os_memmove(hrp, "rdx", hrplen);
@@ -47,32 +49,34 @@ bool address_from_network_and_bytes(
         os_memmove(hrp, "brx", hrplen);
     }
     
-    // We set a lower bound to ensure this is safe
-    if (out_len < hrplen + (in_len * 2) + 7) { // 7 is 6 bytes checksum and 1 byte delimiter (always "1")
+    // Number of 5 bit groups of the input, rounded up for the padding.
+    size_t max_tmp_size = (in_len * 8 + 4) / 5;
+
+    // 8 is 6 bytes checksum, 1 byte delimiter (always "1") and the null terminator
+    if (out_len < hrplen + max_tmp_size + 8) {
         PRINTF("bech32 encoding failed, buffer too small.\n");
         return false;
     }
 
-    // Overestimate required size *2==(8/4) instead of *(8/5)
-    uint8_t tmp_data[MAX_INPUT_SIZE * 2];
+    scratch_mark_t mark = scratch_mark();
+    uint8_t *tmp_data = scratch_alloc(max_tmp_size);
     size_t tmp_size = 0;
-    explicit_bzero(tmp_data, sizeof(tmp_data));
+    explicit_bzero(tmp_data, max_tmp_size);
 
     int pad = 0;
     if (should_pad) {
         pad = 1;
     }
     convert_bits(tmp_data, &tmp_size, 5, in, in_len, 8, pad);
+    bool is_encoded = false;
     if (tmp_size >= out_len) {
         PRINTF("bech32 encoding failed, out of bounds.\n");
-        return false;
-    }
-
-    int err = bech32_encode(out, hrp, tmp_data, tmp_size);
-    if (err == 0) {
+    } else if (bech32_encode(out, hrp, tmp_data, tmp_size) == 0) {
         PRINTF("bech32 encoding failed, encoding failed.\n");
-        return false;
+    } else {
+        is_encoded = true;
     }
 
-    return true;
+    scratch_release(mark);
+    return is_encoded;
 }
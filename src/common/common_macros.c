@@ -64,6 +64,10 @@ bool print_error_by_code(int e) {
             PRINTF("error %d is our custom 'SW_INVALID_PARAM'\n", e);
           return true;
         }
+        case SW_CAPACITY_EXCEEDED: {
+            PRINTF("error %d is our custom 'SW_CAPACITY_EXCEEDED'\n", e);
+          return true;
+        }
         default: break;
     }
     PRINTF("error %d is not known.\n", e);
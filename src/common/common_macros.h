@@ -37,18 +37,34 @@
 
 
 // exception codes
+#define SW_MORE_DATA_AVAILABLE                  0x6100 // | number of bytes left (capped to 0xFF)
 #define SW_USER_REJECTED                        0x6985
 #define SW_FATAL_ERROR_INCORRECT_IMPLEMENTATION 0x6B00
 #define SW_INVALID_PARAM                        0x6B01
 #define SW_INTERNAL_ERROR_ECC                   0x6B02
+#define SW_CAPACITY_EXCEEDED                    0x6B03
 #define SW_INVALID_INSTRUCTION                  0x6D00
 #define SW_INCORRECT_CLA                        0x6E00
 #define SW_OK                                   0x9000
 
+// Result of command handlers and of the helpers they call: `SW_OK` on
+// success, otherwise the status word the command fails with. Errors are
+// returned rather than thrown, THROW is left to SDK syscalls and to
+// violated assertions (`assert`, `FATAL_ERROR`).
+typedef uint16_t status_word_t;
+
 // FUNCTIONS
 // macros for converting raw bytes to uint64_t
 #define U8BE(buf, off) (((uint64_t)(U4BE(buf, off))     << 32) | ((uint64_t)(U4BE(buf, off + 4)) & 0xFFFFFFFF))
 #define U8LE(buf, off) (((uint64_t)(U4LE(buf, off + 4)) << 32) | ((uint64_t)(U4LE(buf, off))     & 0xFFFFFFFF))
+// macro for writing a uint32_t as raw bytes, big endian
+#define WRITE_U4BE(buf, off, value)                  \
+    do {                                             \
+        (buf)[(off) + 0] = ((value) >> 24) & 0xFF;   \
+        (buf)[(off) + 1] = ((value) >> 16) & 0xFF;   \
+        (buf)[(off) + 2] = ((value) >> 8) & 0xFF;    \
+        (buf)[(off) + 3] = (value) & 0xFF;           \
+    } while (0)
 
 // Constants
 #define PUBLIC_KEY_COMPRESSEED_BYTE_COUNT 33
@@ -59,6 +75,9 @@
 #define ECSDA_SIGNATURE_BYTE_COUNT 64
 
 #define NUMBER_OF_BIP32_COMPONENTS_IN_PATH 5
+#define NUMBER_OF_BIP32_COMPONENTS_IN_ACCOUNT_PATH 3
+#define CHAIN_CODE_BYTE_COUNT 32
+#define BIP32_FINGERPRINT_BYTE_COUNT 4
 #define MAX_CHUNK_SIZE 255 
 
 // The biggest of a value split across chunks might be the `rri`
@@ -70,6 +89,7 @@
 #define MAC_LEN 32
 #define HASH512_LEN 64
 #define PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT 65
+// `account || change || address_index` as sent by the host, 4 bytes each
 #define BIP32_PATH_LEN 12
 
 // Returns true if error code was known, else false
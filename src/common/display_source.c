@@ -0,0 +1,151 @@
+#include "display_source.h"
+#include "common_macros.h"
+#include "scratch.h"
+#include "stringify_bip32_path.h"
+
+// Longest component is `2147483647'`, followed by a separator.
+#define BIP32_COMPONENT_STRING_MAX_LENGTH 12
+
+static const char hexadecimal_digits[] = "0123456789abcdef";
+
+static display_source_t display_source(display_source_kind_t kind, const void *value, uint16_t length) {
+    display_source_t source = {
+        .kind = kind,
+        .value = value,
+        .length = length,
+    };
+    return source;
+}
+
+display_source_t text_display_source(const char *text, uint16_t length) {
+    return display_source(DISPLAY_SOURCE_TEXT, text, length);
+}
+
+display_source_t hex_display_source(const uint8_t *bytes, uint16_t byte_count) {
+    return display_source(DISPLAY_SOURCE_HEX, bytes, byte_count);
+}
+
+display_source_t bip32_path_display_source(const uint32_t *bip32_path, uint16_t number_of_components) {
+    return display_source(DISPLAY_SOURCE_BIP32_PATH, bip32_path, number_of_components);
+}
+
+display_source_t uint256_display_source(const uint256_t *uint256) {
+    return display_source(DISPLAY_SOURCE_UINT256, uint256, 0);
+}
+
+display_source_t radix_address_display_source(const radix_address_t *address) {
+    return display_source(DISPLAY_SOURCE_RADIX_ADDRESS, address, 0);
+}
+
+// Digit `index` of the bytes in hexadecimal, most significant first.
+static char hexadecimal_digit_at(const uint8_t *bytes, uint16_t index) {
+    uint8_t byte = bytes[index >> 1];
+    return hexadecimal_digits[(index & 1) ? byte & 0x0F : byte >> 4];
+}
+
+// The value on screen which can't be rendered piecewise, rendered whole at
+// the top of the scratch arena the first time a window of it is rendered.
+// It is kept there while the value is shown, so that seeking only copies a
+// window out of it.
+typedef struct {
+    display_source_t source;
+    const char *string;
+    uint16_t length;
+    scratch_mark_t mark;  // of the arena before `string` was allocated
+    scratch_mark_t end;   // of the arena after `string` was allocated
+} display_source_rendering_t;
+
+static display_source_rendering_t rendering;
+
+// The rendering is only valid while the arena still ends with it, a
+// `scratch_reset` after an exception drops it.
+static bool is_rendering_of(const display_source_t *source) {
+    return rendering.string &&
+        rendering.end == scratch_mark() &&
+        rendering.source.kind == source->kind &&
+        rendering.source.value == source->value &&
+        rendering.source.length == source->length;
+}
+
+void release_display_source_rendering(void) {
+    if (rendering.string && rendering.end == scratch_mark()) {
+        scratch_release(rendering.mark);
+    }
+    explicit_bzero(&rendering, sizeof(rendering));
+}
+
+// Renders the whole value into the scratch arena, writing its length into
+// `output_length`.
+static const char *render_into_scratch(const display_source_t *source, uint16_t *output_length) {
+    char *string;
+    switch (source->kind) {
+        case DISPLAY_SOURCE_BIP32_PATH:
+            string = (char *) scratch_alloc(source->length * BIP32_COMPONENT_STRING_MAX_LENGTH);
+            *output_length = stringify_bip32_path((uint32_t *) source->value, source->length, string);
+            return string;
+        case DISPLAY_SOURCE_UINT256:
+            string = (char *) scratch_alloc(UINT256_DEC_STRING_MAX_LENGTH + 1);
+            *output_length = to_string_uint256(
+                (uint256_t *) source->value,
+                string,
+                UINT256_DEC_STRING_MAX_LENGTH + 1
+            );
+            return string;
+        case DISPLAY_SOURCE_RADIX_ADDRESS:
+            string = (char *) scratch_alloc(RADIX_ADDRESS_BECH32_CHAR_COUNT_MAX + 1);
+            *output_length = to_string_radix_address(
+                (radix_address_t *) source->value,
+                string,
+                RADIX_ADDRESS_BECH32_CHAR_COUNT_MAX + 1
+            );
+            return string;
+        default:
+            FATAL_ERROR("Unknown display source: %d\n", source->kind);
+            return NULL;
+    }
+}
+
+uint16_t render_display_source_window(
+    const display_source_t *source,
+    uint16_t offset,
+    uint8_t window_length,
+    char *output
+) {
+    scratch_mark_t mark = scratch_mark();
+    const char *string = NULL;
+    uint16_t length = 0;
+    switch (source->kind) {
+        case DISPLAY_SOURCE_NONE:
+            break;
+        case DISPLAY_SOURCE_TEXT:
+            string = (const char *) source->value;
+            length = source->length;
+            break;
+        case DISPLAY_SOURCE_HEX:
+            length = 2 * source->length;
+            break;
+        default:
+            if (!is_rendering_of(source)) {
+                release_display_source_rendering();
+                rendering.source = *source;
+                rendering.mark = scratch_mark();
+                rendering.string = render_into_scratch(source, &rendering.length);
+                rendering.end = scratch_mark();
+            }
+            string = rendering.string;
+            length = rendering.length;
+            mark = rendering.end;
+            break;
+    }
+
+    uint8_t rendered = 0;
+    for (; rendered < window_length && offset + rendered < length; ++rendered) {
+        output[rendered] = string
+            ? string[offset + rendered]
+            : hexadecimal_digit_at((const uint8_t *) source->value, offset + rendered);
+    }
+    output[rendered] = '\0';
+
+    scratch_release(mark);
+    return length;
+}
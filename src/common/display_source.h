@@ -0,0 +1,54 @@
+#ifndef DISPLAYSOURCE_H
+#define DISPLAYSOURCE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "radix_address.h"
+#include "uint256.h"
+
+typedef enum {
+    DISPLAY_SOURCE_NONE = 0,
+    DISPLAY_SOURCE_TEXT,           // `length` characters, not null terminated
+    DISPLAY_SOURCE_HEX,            // `length` bytes, two hexadecimal digits each
+    DISPLAY_SOURCE_BIP32_PATH,     // `length` components, e.g. `44'/536'/2'/1/3`
+    DISPLAY_SOURCE_UINT256,        // in decimal
+    DISPLAY_SOURCE_RADIX_ADDRESS,  // bech32 encoded
+} display_source_kind_t;
+
+// A value to display, rendered from its raw bytes a window at a time as the
+// user seeks through it, rather than formatted into a string up front. The
+// value is referred to, not copied, so it must stay valid while displayed,
+// e.g. by pointing into the context of the command.
+typedef struct {
+    display_source_kind_t kind;
+    const void *value;
+    uint16_t length;
+} display_source_t;
+
+display_source_t text_display_source(const char *text, uint16_t length);
+display_source_t hex_display_source(const uint8_t *bytes, uint16_t byte_count);
+display_source_t bip32_path_display_source(const uint32_t *bip32_path, uint16_t number_of_components);
+display_source_t uint256_display_source(const uint256_t *uint256);
+display_source_t radix_address_display_source(const radix_address_t *address);
+
+// Renders up to `window_length` characters of the value, starting at
+// character `offset`, into `output` (null terminated, so of at least
+// `window_length + 1` chars), returning the length of the whole value.
+//
+// Text and hexadecimal values are rendered character by character. Decimal,
+// bech32 and path values can't be, they are rendered whole into the scratch
+// arena once, and following windows of the same source are copied out of
+// that rendering, see `release_display_source_rendering`.
+uint16_t render_display_source_window(
+    const display_source_t *source,
+    uint16_t offset,
+    uint8_t window_length,
+    char *output
+);
+
+// Frees the scratch arena of the rendering kept by
+// `render_display_source_window`, to be called once the value is no longer
+// shown, before anything else takes temporaries from the arena.
+void release_display_source_rendering(void);
+
+#endif
@@ -3,7 +3,10 @@
 
 #include "key_and_signatures.h"
 #include "transfer.h"
+#include "atom_parser.h"
+#include "transfer_summary.h"
 #include "common_macros.h"
+#include "scratch.h"
 
 typedef struct {
 	uint32_t bip32_path[NUMBER_OF_BIP32_COMPONENTS_IN_PATH];
@@ -11,6 +14,20 @@ typedef struct {
     radix_address_t address;
 } get_public_key_context_t;
 
+// Upper bound of keys returned by a single `GET_PUBLIC_KEYS` response, each
+// key being `PUBLIC_KEY_COMPRESSEED_BYTE_COUNT` bytes, this is as many keys as
+// fits in `G_io_apdu_buffer` (together with the two bytes of status word).
+#define MAX_NUMBER_OF_PUBLIC_KEYS_PER_RESPONSE 7
+
+typedef struct {
+    uint32_t bip32_path[NUMBER_OF_BIP32_COMPONENTS_IN_PATH]; // last component is the start index
+    uint8_t number_of_keys;
+} get_public_keys_context_t;
+
+typedef struct {
+    uint32_t bip32_path[NUMBER_OF_BIP32_COMPONENTS_IN_ACCOUNT_PATH];
+} get_extended_public_key_context_t;
+
 typedef struct {
     uint32_t bip32_path[NUMBER_OF_BIP32_COMPONENTS_IN_PATH];
     uint8_t public_key_of_other_party[PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT];
@@ -22,15 +39,96 @@ typedef struct {
 	uint8_t hash[HASH256_BYTE_COUNT];
 } sign_hash_context_t;
 
+// Upper bound of hashes signed in one `SIGN_HASHES` batch.
+#define MAX_NUMBER_OF_HASHES_TO_SIGN 8
+
+// Upper bound of signatures returned by a single response, each signature
+// being `ECSDA_SIGNATURE_BYTE_COUNT` bytes, this is as many signatures as fits
+// in `G_io_apdu_buffer` (together with the two bytes of status word).
+#define MAX_NUMBER_OF_SIGNATURES_PER_RESPONSE 4
+
+// Chained input: BIP32 path (12 bytes) followed by the hashes.
+#define MAX_SIGN_HASHES_INPUT_LENGTH (12 + MAX_NUMBER_OF_HASHES_TO_SIGN * HASH256_BYTE_COUNT)
+
+typedef struct {
+    uint32_t bip32_path[NUMBER_OF_BIP32_COMPONENTS_IN_PATH];
+    uint8_t number_of_hashes;
+    // Holds the hashes (`HASH256_BYTE_COUNT` bytes each) until they are signed,
+    // thereafter the signatures (`ECSDA_SIGNATURE_BYTE_COUNT` bytes each).
+    uint8_t hashes_then_signatures[MAX_NUMBER_OF_HASHES_TO_SIGN * ECSDA_SIGNATURE_BYTE_COUNT];
+    // SHA256 of the hashes, displayed for review.
+    uint8_t digest_of_hashes[HASH256_BYTE_COUNT];
+} sign_hashes_context_t;
+
+typedef struct {
+    uint32_t bip32_paths[MAX_NUMBER_OF_SIGNATURES_PER_RESPONSE][NUMBER_OF_BIP32_COMPONENTS_IN_PATH];
+    uint8_t number_of_paths;
+    uint8_t hash[HASH256_BYTE_COUNT];
+} sign_hash_multi_path_context_t;
+
+// Chained input: BIP32 path (12 bytes) followed by the transaction.
+#define MAX_SIGN_TX_INPUT_LENGTH (12 + 0xFFFF)
+
+#define SIGN_TX_SESSION_NONCE_BYTE_COUNT 8
+
+typedef struct {
+    uint32_t bip32_path[NUMBER_OF_BIP32_COMPONENTS_IN_PATH];
+    // Compressed public key of the signer, derived once per transaction, to
+    // recognize transfers of change back to the signer.
+    uint8_t signer_public_key[PUBLIC_KEY_COMPRESSEED_BYTE_COUNT];
+    uint32_t tx_bytes_received;
+    // Random nonce identifying the upload, needed to resume it after the
+    // connection has been reset.
+    uint8_t session_nonce[SIGN_TX_SESSION_NONCE_BYTE_COUNT];
+    uint32_t number_of_chunks_received;
+    // Set once a chunk has been fully processed and acknowledged, cleared
+    // while processing the next one, so a failed chunk can never be resumed.
+    bool has_checkpoint;
+    cx_sha256_t hasher;
+    uint8_t hash[HASH256_BYTE_COUNT];
+    atom_parser_t atom_parser;
+    transfer_summaries_t transfer_summaries;
+    uint8_t number_of_summaries_reviewed;
+} sign_tx_context_t;
+
 #define MAX_SERIALIZER_LENGTH 100
 
 // To save memory, we store all the context types in a single global union,
 // taking advantage of the fact that only one command is executed at a time.
-typedef union {
-    get_public_key_context_t get_public_key_context;
-    do_key_exchange_context_t do_key_exchange_context;
-    sign_hash_context_t sign_hash_context;
-} command_context_u;
-extern command_context_u global;
+// The scratch arena is shared by the helpers of all commands, next to it.
+typedef struct {
+    union {
+        get_public_key_context_t get_public_key_context;
+        get_public_keys_context_t get_public_keys_context;
+        get_extended_public_key_context_t get_extended_public_key_context;
+        do_key_exchange_context_t do_key_exchange_context;
+        sign_hash_context_t sign_hash_context;
+        sign_hashes_context_t sign_hashes_context;
+        sign_hash_multi_path_context_t sign_hash_multi_path_context;
+        sign_tx_context_t sign_tx_context;
+    };
+    scratch_arena_t scratch;
+} command_context_t;
+extern command_context_t global;
+
+// RAM budget of `global`. The Nano S has 4 KB of RAM, of which 1 KB is the
+// stack and much of the rest the buffers of the SDK (APDU, SEPROXYHAL, UX).
+// signTx is the largest context, mostly the atom parser (RRI table) and
+// the transfer summaries, which bound what a transaction may hold.
+#define COMMAND_CONTEXT_MAX_BYTE_COUNT 1280
+
+_Static_assert(
+    sizeof(command_context_t) <= COMMAND_CONTEXT_MAX_BYTE_COUNT,
+    "Command contexts exceed their RAM budget"
+);
+
+// Remainder of a response larger than one APDU, to be read with
+// GET_MORE_DATA. Kept outside `global` since it points into it.
+typedef struct {
+    const uint8_t *data;
+    uint16_t length;
+} output_queue_t;
+
+extern output_queue_t output_queue;
 
 #endif
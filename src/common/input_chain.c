@@ -0,0 +1,104 @@
+#include "input_chain.h"
+#include <os.h>
+#include "common_macros.h"
+
+typedef struct {
+    bool is_open;
+    uint8_t ins;
+    uint8_t p1;
+    uint32_t total_length;
+
+    // Unread bytes of the current APDU.
+    uint8_t *data;
+    uint16_t data_length;
+
+    // Bytes of an item split across APDUs, see `input_chain_read`.
+    uint8_t carry[INPUT_CHAIN_MAX_ITEM_BYTE_COUNT];
+    uint8_t carry_length;
+} input_chain_t;
+
+static input_chain_t chain;
+
+void input_chain_reset(void) {
+    explicit_bzero(&chain, sizeof(chain));
+}
+
+status_word_t input_chain_receive(
+    uint8_t ins,
+    uint8_t p1,
+    uint8_t *data,
+    uint16_t data_length,
+    uint32_t max_total_length
+) {
+    bool is_first = p1 == P1_CHAIN_FIRST || p1 == (P1_CHAIN_FIRST | P1_CHAIN_LAST);
+    bool is_continuation = p1 == P1_CHAIN_CONTINUE || p1 == (P1_CHAIN_CONTINUE | P1_CHAIN_LAST);
+    if (!is_first && !is_continuation) {
+        PRINTF("Invalid chaining flags in P1: %d\n", p1);
+        return SW_INVALID_PARAM;
+    }
+
+    if (is_first) {
+        input_chain_reset();
+        chain.is_open = true;
+        chain.ins = ins;
+    } else if (!chain.is_open || chain.ins != ins) {
+        PRINTF("No chained input to continue.\n");
+        input_chain_reset();
+        return SW_INVALID_PARAM;
+    }
+
+    if (data_length > max_total_length - chain.total_length) {
+        PRINTF("Chained input exceeds: %u bytes\n", max_total_length);
+        input_chain_reset();
+        return SW_INVALID_PARAM;
+    }
+    chain.total_length += data_length;
+    chain.p1 = p1;
+    chain.data = data;
+    chain.data_length = data_length;
+    if (p1 & P1_CHAIN_LAST) {
+        chain.is_open = false;
+    }
+    return SW_OK;
+}
+
+bool input_chain_is_first_chunk(void) {
+    return (chain.p1 & P1_CHAIN_FIRST) != 0;
+}
+
+bool input_chain_is_last_chunk(void) {
+    return (chain.p1 & P1_CHAIN_LAST) != 0;
+}
+
+bool input_chain_read(uint8_t *output, uint16_t count) {
+    assert(count <= INPUT_CHAIN_MAX_ITEM_BYTE_COUNT && chain.carry_length < count);
+
+    uint16_t missing = count - chain.carry_length;
+    if (chain.data_length < missing) {
+        os_memcpy(chain.carry + chain.carry_length, chain.data, chain.data_length);
+        chain.carry_length += chain.data_length;
+        chain.data += chain.data_length;
+        chain.data_length = 0;
+        return false;
+    }
+
+    os_memcpy(output, chain.carry, chain.carry_length);
+    os_memcpy(output + chain.carry_length, chain.data, missing);
+    chain.carry_length = 0;
+    chain.data += missing;
+    chain.data_length -= missing;
+    return true;
+}
+
+uint16_t input_chain_read_remaining(uint8_t **output) {
+    assert(chain.carry_length == 0);
+    uint16_t length = chain.data_length;
+    *output = chain.data;
+    chain.data += length;
+    chain.data_length = 0;
+    return length;
+}
+
+bool input_chain_is_fully_read(void) {
+    return chain.data_length == 0 && chain.carry_length == 0;
+}
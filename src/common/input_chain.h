@@ -0,0 +1,51 @@
+#ifndef INPUTCHAIN_H
+#define INPUTCHAIN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "common_macros.h"
+
+// P1 flags of commands whose input is chained over several APDUs. The first
+// APDU is flagged `P1_CHAIN_FIRST`, the following ones `P1_CHAIN_CONTINUE`,
+// and the final one additionally `P1_CHAIN_LAST` (a single APDU input is
+// `P1_CHAIN_FIRST | P1_CHAIN_LAST`).
+#define P1_CHAIN_FIRST 0x01
+#define P1_CHAIN_CONTINUE 0x02
+#define P1_CHAIN_LAST 0x04
+
+// Largest item which can be read in one piece when split across two APDUs.
+#define INPUT_CHAIN_MAX_ITEM_BYTE_COUNT 32
+
+// Closes the current chain, if any.
+void input_chain_reset(void);
+
+// Called by the dispatcher with every APDU of a chained command, before the
+// handler. Returns `SW_INVALID_PARAM` if the flags in `p1` are invalid, if
+// they are out of order (e.g. continuing a chain of another command, or one
+// already closed) or if the total input would exceed `max_total_length`.
+status_word_t input_chain_receive(
+    uint8_t ins,
+    uint8_t p1,
+    uint8_t *data,
+    uint16_t data_length,
+    uint32_t max_total_length
+);
+
+bool input_chain_is_first_chunk(void);
+bool input_chain_is_last_chunk(void);
+
+// Reads the next `count` (at most `INPUT_CHAIN_MAX_ITEM_BYTE_COUNT`) bytes of
+// input into `output`. Returns false if the current APDU ends before, in
+// which case its remaining bytes are kept and the read must be repeated
+// (with the same `count`) with the next APDU.
+bool input_chain_read(uint8_t *output, uint16_t count);
+
+// Points `output` to all remaining bytes of the current APDU, without copying
+// them, returning their number.
+uint16_t input_chain_read_remaining(uint8_t **output);
+
+// Returns true if all input of the current APDU has been read, including
+// bytes kept by a partial `input_chain_read`.
+bool input_chain_is_fully_read(void);
+
+#endif
@@ -6,22 +6,36 @@
 #include "os_io_seproxyhal.h"
 #include "stringify_bip32_path.h"
 #include "common_macros.h"
+#include "stats.h"
+#include "trace.h"
+#include "scratch.h"
 
 #define KEY_SEED_BYTE_COUNT 32
 
+// Derives the node at the first `number_of_bip32_components` components of
+// `bip32path`, writing its private key bytes into `key_seed` and its chain code
+// into `chain_code_nullable` if not NULL.
 static void get_key_seed(
     uint8_t* key_seed, 
-    uint32_t *bip32path
+    uint8_t* chain_code_nullable,
+    uint32_t *bip32path,
+    unsigned int number_of_bip32_components
 ) {
 
     BEGIN_TRY {
         TRY {
             io_seproxyhal_io_heartbeat();
-            os_perso_derive_node_bip32(CX_CURVE_256K1, bip32path, 5, key_seed, NULL);
+            stats_count_operation(STATS_OPERATION_DERIVATION);
+            TRACE(TRACE_EVENT_DERIVATION_BEGIN, number_of_bip32_components, bip32path[number_of_bip32_components - 1]);
+            os_perso_derive_node_bip32(CX_CURVE_256K1, bip32path, number_of_bip32_components, key_seed, chain_code_nullable);
+            TRACE(TRACE_EVENT_DERIVATION_END, 0, 0);
             io_seproxyhal_io_heartbeat();
         }
         CATCH_OTHER(e) {
             os_memset(key_seed, 0, KEY_SEED_BYTE_COUNT);
+            if (chain_code_nullable) {
+                os_memset(chain_code_nullable, 0, CHAIN_CODE_BYTE_COUNT);
+            }
             switch (e) {
                 case EXCEPTION_SECURITY: {
                     PRINTF("FAILED call 'os_perso_derive_node_bip32', error: 'EXCEPTION_SECURITY' (==%d)\n", e);
@@ -53,6 +67,12 @@ const unsigned char secp256k1_p_plus_1_div_4[] = {
     0x3f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbf, 0xff, 0xff, 0x0c
 };
 
+static uint8_t const secp256k1_n[] = {
+  //n:  0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+  0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b, 0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41
+};
+
 static uint8_t const secp256k1_b[] = { 
   //b:  0x07
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
@@ -77,8 +97,9 @@ void uncompress_public_key(
     assert(compressed_pubkey_len == PUBLIC_KEY_COMPRESSEED_BYTE_COUNT);
     assert(uncompressed_pubkey_len >= PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT);
 
-    uint8_t x[FIELD_SCALAR_SIZE];
-	uint8_t y[FIELD_SCALAR_SIZE];
+    scratch_mark_t mark = scratch_mark();
+    uint8_t *x = scratch_alloc(FIELD_SCALAR_SIZE);
+    uint8_t *y = scratch_alloc(FIELD_SCALAR_SIZE);
 
     os_memcpy(x, compressed_pubkey + 1, FIELD_SCALAR_SIZE);
     cx_math_multm(y, x, x, MOD); // y == x^2 % p
@@ -94,13 +115,14 @@ void uncompress_public_key(
     os_memset(uncompressed_pubkey_res, 0x04, 1);
     os_memcpy(uncompressed_pubkey_res + 1, x, FIELD_SCALAR_SIZE);
     os_memcpy(uncompressed_pubkey_res + 1 + FIELD_SCALAR_SIZE, y, FIELD_SCALAR_SIZE);
+    scratch_release(mark);
 }
 
-void compress_public_key(cx_ecfp_public_key_t *public_key) {
+bool compress_public_key(cx_ecfp_public_key_t *public_key) {
     // Uncompressed key has 0x04 + X (32 bytes) + Y (32 bytes).
     if (public_key->W_len != 65 || public_key->W[0] != 0x04) {
         PRINTF("compressPubKey: Input public key is incorrect\n");
-        THROW(SW_INVALID_PARAM);
+        return false;
     }
 
     // check if Y is even or odd. Assuming big-endian, just check the last byte.
@@ -113,11 +135,14 @@ void compress_public_key(cx_ecfp_public_key_t *public_key) {
     }
 
     public_key->W_len = PUBLIC_KEY_COMPRESSEED_BYTE_COUNT;
+    return true;
 }
 
-static void format_signature_out(const uint8_t *signature)
+// Converts the DER encoded `signature` into the 64 bytes `r || s` format,
+// written to `output`.
+static void format_signature_out(const uint8_t *signature, uint8_t *output)
 {
-    os_memset(G_io_apdu_buffer + 1, 0x00, 64);
+    os_memset(output, 0x00, ECSDA_SIGNATURE_BYTE_COUNT);
     uint8_t xoffset = 4; //point to r value
     //copy r
     uint8_t xlength = signature[xoffset - 1];
@@ -127,7 +152,7 @@ static void format_signature_out(const uint8_t *signature)
         xoffset++;
     }
     uint8_t offset = 0;
-    memmove(G_io_apdu_buffer + offset + 32 - xlength, signature + xoffset, xlength);
+    memmove(output + offset + 32 - xlength, signature + xoffset, xlength);
     offset += 32;
     xoffset += xlength + 2; //move over rvalue and TagLEn
     //copy s value
@@ -137,7 +162,7 @@ static void format_signature_out(const uint8_t *signature)
         xlength = 32;
         xoffset++;
     }
-    memmove(G_io_apdu_buffer + offset + 32 - xlength, signature + xoffset, xlength);
+    memmove(output + offset + 32 - xlength, signature + xoffset, xlength);
 }
 
 static int ecdsa_sign_hash(
@@ -161,6 +186,8 @@ static int ecdsa_sign_hash(
     BEGIN_TRY {
         TRY {
                 io_seproxyhal_io_heartbeat();
+                stats_count_operation(STATS_OPERATION_SIGNING);
+                TRACE(TRACE_EVENT_SIGNING_BEGIN, inlen, 0);
                 result = cx_ecdsa_sign(
                     privateKey,
                     CX_LAST |
@@ -170,6 +197,7 @@ static int ecdsa_sign_hash(
                 if (result_info & CX_ECCINFO_PARITY_ODD) {
                     out[0] |= 0x01;
                 }
+                TRACE(TRACE_EVENT_SIGNING_END, result, 0);
       
         }
         CATCH_OTHER(e) { error = e; }
@@ -187,33 +215,234 @@ static int ecdsa_sign_hash(
     return result;
 }
 
+// ======= PARENT NODE CACHE ======================
+
+// Public key and chain code of the node `44'/536'/account'/change` used
+// last. Address-range scans derive many keys sharing these first four
+// components, with this cache each of them only costs a single (public) child
+// derivation step instead of a full walk from the master seed. Holds no
+// private key material.
+typedef struct {
+    bool is_valid;
+    uint32_t bip32_path_prefix[NUMBER_OF_BIP32_COMPONENTS_IN_PATH - 1];
+    uint8_t public_key[PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT];
+    uint8_t chain_code[CHAIN_CODE_BYTE_COUNT];
+} parent_node_cache_t;
+
+static parent_node_cache_t parent_node_cache;
+
+static bool is_parent_node_cached_for(uint32_t *bip32path) {
+    return parent_node_cache.is_valid && os_memcmp(
+        parent_node_cache.bip32_path_prefix,
+        bip32path,
+        sizeof(parent_node_cache.bip32_path_prefix)
+    ) == 0;
+}
+
+// Derives the node at the first `number_of_bip32_components` components of
+// `bip32path`, writing its uncompressed public key into `public_key` and its
+// chain code into `chain_code_nullable` if not NULL. The private key never
+// leaves this function.
+static void derive_node_public_key_and_chain_code(
+    uint32_t *bip32path,
+    unsigned int number_of_bip32_components,
+    cx_ecfp_public_key_t *public_key,
+    uint8_t *chain_code_nullable
+) {
+    volatile cx_ecfp_private_key_t private_key_local;
+    volatile uint8_t key_seed[KEY_SEED_BYTE_COUNT];
+
+    BEGIN_TRY {
+        TRY {
+            get_key_seed(
+                (uint8_t *) key_seed,
+                chain_code_nullable,
+                bip32path,
+                number_of_bip32_components
+            );
+
+            cx_ecfp_init_private_key(
+                                     CX_CURVE_SECP256K1,
+                                     (uint8_t *) key_seed,
+                                     KEY_SEED_BYTE_COUNT,
+                                     (cx_ecfp_private_key_t *) &private_key_local
+                                     );
+
+            cx_ecfp_generate_pair(
+                                  CX_CURVE_SECP256K1,
+                                  public_key,
+                                  (cx_ecfp_private_key_t *) &private_key_local,
+                                  1 // keep the private key value.
+                                  );
+        }
+        FINALLY {
+            explicit_bzero((uint8_t *) key_seed, KEY_SEED_BYTE_COUNT);
+            explicit_bzero((cx_ecfp_private_key_t *)&private_key_local, sizeof(private_key_local));
+        }
+    }
+    END_TRY;
+}
+
+static void fill_parent_node_cache(uint32_t *bip32path) {
+    clear_parent_node_cache();
+
+    cx_ecfp_public_key_t public_key_local;
+
+    derive_node_public_key_and_chain_code(
+        bip32path,
+        NUMBER_OF_BIP32_COMPONENTS_IN_PATH - 1,
+        &public_key_local,
+        parent_node_cache.chain_code
+    );
+
+    os_memcpy(parent_node_cache.public_key, public_key_local.W, PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT);
+    os_memcpy(parent_node_cache.bip32_path_prefix, bip32path, sizeof(parent_node_cache.bip32_path_prefix));
+    parent_node_cache.is_valid = true;
+}
+
+// BIP32 `CKDpub`, derives the (uncompressed) public key of the non-hardened
+// child at `index` of the cached parent node:
+// `I = HMAC-SHA512(c_par, serP(K_par) || ser32(index))`, `K_i = point(I_L) + K_par`.
+// Returns false for the (astronomically unlikely) invalid `I_L`, in which case
+// the caller should fall back to a full derivation.
+static bool derive_child_public_key_from_parent_node_cache(
+    uint32_t index,
+    cx_ecfp_public_key_t *public_key
+) {
+    uint8_t data[PUBLIC_KEY_COMPRESSEED_BYTE_COUNT + 4];
+    uint8_t hmac[HASH512_LEN];
+    volatile cx_ecfp_private_key_t tweak;
+    volatile bool is_tweak_valid = false;
+
+    // serP(K_par)
+    data[0] = (parent_node_cache.public_key[PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT - 1] & 1) ? 0x03 : 0x02;
+    os_memcpy(data + 1, parent_node_cache.public_key + 1, FIELD_SCALAR_SIZE);
+    // ser32(index)
+    data[PUBLIC_KEY_COMPRESSEED_BYTE_COUNT + 0] = (index >> 24) & 0xFF;
+    data[PUBLIC_KEY_COMPRESSEED_BYTE_COUNT + 1] = (index >> 16) & 0xFF;
+    data[PUBLIC_KEY_COMPRESSEED_BYTE_COUNT + 2] = (index >> 8) & 0xFF;
+    data[PUBLIC_KEY_COMPRESSEED_BYTE_COUNT + 3] = index & 0xFF;
+
+    BEGIN_TRY {
+        TRY {
+            cx_hmac_sha512(
+                parent_node_cache.chain_code, CHAIN_CODE_BYTE_COUNT,
+                data, sizeof(data),
+                hmac, HASH512_LEN
+            );
+
+            is_tweak_valid = !cx_math_is_zero(hmac, FIELD_SCALAR_SIZE) &&
+                cx_math_cmp(hmac, (unsigned char *)secp256k1_n, FIELD_SCALAR_SIZE) < 0;
+
+            if (is_tweak_valid) {
+                // point(I_L)
+                cx_ecfp_init_private_key(
+                                         CX_CURVE_SECP256K1,
+                                         hmac,
+                                         FIELD_SCALAR_SIZE,
+                                         (cx_ecfp_private_key_t *) &tweak
+                                         );
+                cx_ecfp_generate_pair(
+                                      CX_CURVE_SECP256K1,
+                                      public_key,
+                                      (cx_ecfp_private_key_t *) &tweak,
+                                      1 // keep the private key value.
+                                      );
+
+                // point(I_L) + K_par
+                cx_ecfp_add_point(
+                                  CX_CURVE_SECP256K1,
+                                  public_key->W,
+                                  public_key->W,
+                                  parent_node_cache.public_key,
+                                  PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT
+                                  );
+            }
+        }
+        FINALLY {
+            explicit_bzero(hmac, sizeof(hmac));
+            explicit_bzero((cx_ecfp_private_key_t *)&tweak, sizeof(tweak));
+        }
+    }
+    END_TRY;
+
+    return is_tweak_valid;
+}
+
+// Derives the public key at `bip32path` using the parent node cache, which
+// is (re)filled if the first four components of `bip32path` differ from the
+// cached ones. Returns false if the path cannot be derived this way.
+static bool derive_public_key_using_parent_node_cache(
+    uint32_t *bip32path,
+    cx_ecfp_public_key_t *public_key
+) {
+    uint32_t index = bip32path[NUMBER_OF_BIP32_COMPONENTS_IN_PATH - 1];
+    if (index & 0x80000000) {
+        // Hardened child, cannot be derived from parent public key.
+        return false;
+    }
+
+    volatile uint16_t error = 0;
+    volatile bool success = false;
+
+    BEGIN_TRY {
+        TRY {
+            if (!is_parent_node_cached_for(bip32path)) {
+                fill_parent_node_cache(bip32path);
+            }
+            success = derive_child_public_key_from_parent_node_cache(index, public_key);
+        }
+        CATCH_OTHER(e) { error = e; }
+        FINALLY {}
+    }
+    END_TRY;
+
+    if (error) {
+        print_error_by_code(error);
+        clear_parent_node_cache();
+        return false;
+    }
+
+    return success;
+}
+
 // ======= HEADER FUNCTIONS ======================
 
-int parse_bip32_path_from_apdu_command(
+void clear_parent_node_cache(void) {
+    explicit_bzero(&parent_node_cache, sizeof(parent_node_cache));
+}
+
+void parse_bip32_account_path_from_apdu_command(
     uint8_t *data_buffer,
-    uint32_t *output_bip32path,
-    char *output_bip32String, // might be null
-    unsigned short output_bip32_pathString_length
+    uint32_t *output_bip32path
 ) {
-    uint16_t byte_count_bip_component = 4;
-    
-    uint32_t bip32_path[5];
-
     // BIP32 Purpose
     uint32_t purpose = 44 | 0x80000000; // BIP44 - hardened
-    bip32_path[0] = purpose;
+    output_bip32path[0] = purpose;
 
     // BIP32 coin_type
     uint32_t coin_type = 536 | 0x80000000; // Radix - hardened
-    bip32_path[1] = coin_type;
+    output_bip32path[1] = coin_type;
 
-    uint32_t account = U4BE(data_buffer, 0 * byte_count_bip_component) | 0x80000000; // hardened 
-    bip32_path[2] = account;
+    uint32_t account = U4BE(data_buffer, 0) | 0x80000000; // hardened 
+    output_bip32path[2] = account;
+}
+
+status_word_t parse_bip32_path_from_apdu_command(
+    uint8_t *data_buffer,
+    uint32_t *output_bip32path
+) {
+    uint16_t byte_count_bip_component = 4;
+    
+    uint32_t bip32_path[5];
+
+    // `44'/536'/account'`
+    parse_bip32_account_path_from_apdu_command(data_buffer, bip32_path);
 
     uint32_t change = U4BE(data_buffer, 1 * byte_count_bip_component);
     if ((change != 0) && (change != 1)) {
         PRINTF("BIP32 'change' must be 0 or 1, but was: %u\n", change);
-        THROW(SW_INVALID_PARAM);
+        return SW_INVALID_PARAM;
     }
  
     bip32_path[3] = change;
@@ -222,26 +451,7 @@ int parse_bip32_path_from_apdu_command(
     bip32_path[4] = address_index;
 
     os_memcpy(output_bip32path, bip32_path, 20);
-
-    if (output_bip32String) {
-        if (output_bip32_pathString_length != BIP32_PATH_STRING_MAX_LENGTH) {
-            PRINTF("Wrong length of output_bip32_pathString_length, is: %d, but expected: %d\n", output_bip32_pathString_length, BIP32_PATH_STRING_MAX_LENGTH);
-            THROW(SW_INVALID_PARAM);
-        }
-        char bip32_pathString_null_terminated[BIP32_PATH_STRING_MAX_LENGTH];
-    	int length_of_bip32_string_path = stringify_bip32_path(
-            output_bip32path,
-            5,
-            bip32_pathString_null_terminated
-        );
-
-        os_memset(output_bip32String, 0, BIP32_PATH_STRING_MAX_LENGTH);
-    	os_memmove(output_bip32String, bip32_pathString_null_terminated, length_of_bip32_string_path);
-
-        return length_of_bip32_string_path;
-    } else {
-        return 0;
-    }
+    return SW_OK;
 }
 
 
@@ -257,9 +467,16 @@ bool derive_radix_key_pair_should_compress(
     volatile uint8_t key_seed[KEY_SEED_BYTE_COUNT];
     volatile uint16_t error = 0;
 
+    // Only the public key is requested, try to derive it from the parent node
+    // cache and skip the full walk from the master seed.
+    if (public_key_nullable && !private_key_nullable &&
+        derive_public_key_using_parent_node_cache(bip32path, (cx_ecfp_public_key_t *) public_key_nullable)) {
+        return !should_compress || compress_public_key((cx_ecfp_public_key_t *)public_key_nullable);
+    }
+
     BEGIN_TRY {
         TRY {
-            get_key_seed((uint8_t *)key_seed, bip32path);
+            get_key_seed((uint8_t *)key_seed, NULL, bip32path, NUMBER_OF_BIP32_COMPONENTS_IN_PATH);
             
             cx_ecfp_init_private_key(
                                      CX_CURVE_SECP256K1,
@@ -299,7 +516,7 @@ bool derive_radix_key_pair_should_compress(
         }
         CATCH_OTHER(e) { error = e; }
         FINALLY { 
-            explicit_bzero((uint8_t *) key_seed, sizeof(KEY_SEED_BYTE_COUNT));
+            explicit_bzero((uint8_t *) key_seed, KEY_SEED_BYTE_COUNT);
             explicit_bzero((cx_ecfp_private_key_t *)&private_key_local, sizeof(private_key_local));
         }
     }
@@ -307,13 +524,78 @@ bool derive_radix_key_pair_should_compress(
     
     if (error) {
         print_error_by_code(error);
+    } else if (public_key_nullable && should_compress &&
+               !compress_public_key((cx_ecfp_public_key_t *)public_key_nullable)) {
+        error = SW_INTERNAL_ERROR_ECC;
+    }
+
+    if (error) {
+        // Callers skip their own wipe when this fails, leave no key behind.
+        if (private_key_nullable) {
+            explicit_bzero((cx_ecfp_private_key_t *)private_key_nullable, sizeof(cx_ecfp_private_key_t));
+        }
         return false;
     }
 
-    if (public_key_nullable && should_compress) {
-        compress_public_key((cx_ecfp_public_key_t *)public_key_nullable);
+    return true;
+}
+
+bool derive_extended_public_key(
+    uint32_t *bip32path,
+    unsigned int number_of_bip32_components,
+    cx_ecfp_public_key_t *public_key,
+    uint8_t *chain_code,
+    uint8_t *parent_fingerprint
+) {
+    assert(number_of_bip32_components > 0);
+
+    cx_ecfp_public_key_t parent_public_key;
+    uint8_t parent_public_key_hash[HASH256_BYTE_COUNT];
+    cx_ripemd160_t ripemd160;
+    volatile uint16_t error = 0;
+
+    BEGIN_TRY {
+        TRY {
+            derive_node_public_key_and_chain_code(
+                bip32path,
+                number_of_bip32_components,
+                public_key,
+                chain_code
+            );
+            derive_node_public_key_and_chain_code(
+                bip32path,
+                number_of_bip32_components - 1,
+                &parent_public_key,
+                NULL
+            );
+
+            if (compress_public_key(public_key) && compress_public_key(&parent_public_key)) {
+                // Fingerprint is the first four bytes of `RIPEMD160(SHA256(serP(K_par)))`
+                cx_hash_sha256(
+                    parent_public_key.W, PUBLIC_KEY_COMPRESSEED_BYTE_COUNT,
+                    parent_public_key_hash, HASH256_BYTE_COUNT
+                );
+                cx_ripemd160_init(&ripemd160);
+                cx_hash(
+                    &ripemd160.header, CX_LAST,
+                    parent_public_key_hash, HASH256_BYTE_COUNT,
+                    parent_public_key_hash, HASH256_BYTE_COUNT
+                );
+                os_memcpy(parent_fingerprint, parent_public_key_hash, BIP32_FINGERPRINT_BYTE_COUNT);
+            } else {
+                error = SW_INTERNAL_ERROR_ECC;
+            }
+        }
+        CATCH_OTHER(e) { error = e; }
+        FINALLY {}
+    }
+    END_TRY;
+
+    if (error) {
+        print_error_by_code(error);
+        return false;
     }
- 
+
     return true;
 }
 
@@ -325,32 +607,56 @@ bool derive_radix_key_pair(
 }
 
 
-size_t derive_sign_move_to_global_buffer(uint32_t *bip32path,
-                                         const uint8_t *hash) {
-    volatile cx_ecfp_public_key_t public_key;
-    volatile cx_ecfp_private_key_t privateKey;
-    derive_radix_key_pair(bip32path, &public_key, &privateKey);
-
+size_t sign_hash_move_to_buffer(
+    cx_ecfp_private_key_t *private_key,
+    const uint8_t *hash,
+    uint8_t *output_signature
+) {
     int over_estimated_DER_sig_length = 80;  // min length is 70.
-    volatile uint8_t der_sig[over_estimated_DER_sig_length + 1];
+    scratch_mark_t mark = scratch_mark();
+    volatile uint8_t *der_sig = scratch_alloc(over_estimated_DER_sig_length + 1);
 
     int actual_DER_sig_length = ecdsa_sign_hash(
-        (cx_ecfp_private_key_t *)&privateKey,
+        private_key,
         NULL,  // pubkey not needed for sign
-        hash, 32, // in 
+        hash, HASH256_BYTE_COUNT, // in 
         der_sig, over_estimated_DER_sig_length, // out
         true  // use deterministic signing
     );
 
+    int der_signature_length = der_sig[1] + 2;
+    size_t signature_length = 0;
+    if (actual_DER_sig_length == 0 || der_signature_length != actual_DER_sig_length) {
+        PRINTF("DER signature length mismatch\n");
+    } else {
+        format_signature_out((uint8_t *)der_sig, output_signature);
+        signature_length = ECSDA_SIGNATURE_BYTE_COUNT;
+    }
+
+    scratch_release(mark);
+    return signature_length;
+}
+
+size_t derive_sign_move_to_global_buffer(uint32_t *bip32path,
+                                         const uint8_t *hash) {
+    volatile cx_ecfp_public_key_t public_key;
+    volatile cx_ecfp_private_key_t privateKey;
+    size_t signature_length = 0;
+    if (derive_radix_key_pair(bip32path, &public_key, &privateKey)) {
+        signature_length = sign_hash_move_to_buffer(
+            (cx_ecfp_private_key_t *)&privateKey,
+            hash,
+            G_io_apdu_buffer
+        );
+    }
+
     // Ultra important step, MUST zero out the private, else sensitive information is leaked.
     explicit_bzero((cx_ecfp_private_key_t *)&privateKey, sizeof(cx_ecfp_private_key_t));
 
-    int der_signature_length = der_sig[1] + 2;
-    if (der_signature_length != actual_DER_sig_length) {
-        FATAL_ERROR("LENGTH MISMATCH");
+    if (signature_length != ECSDA_SIGNATURE_BYTE_COUNT) {
+        PRINTF("Signature length mismatch\n");
+        return 0;
     }
 
-    format_signature_out((uint8_t *)der_sig);
-    
-    return ECSDA_SIGNATURE_BYTE_COUNT;
+    return signature_length;
 }
@@ -1,13 +1,27 @@
 #include "stdint.h"
 #include <cx.h>
+#include "common_macros.h"
 
-int parse_bip32_path_from_apdu_command(
+// Reads the 4 byte `account` at the start of `data_buffer`, writing the
+// (hardened) path `44'/536'/account'` into `output_bip32path`.
+void parse_bip32_account_path_from_apdu_command(
     uint8_t *data_buffer,
-    uint32_t *output_bip32path,
-    char *output_bip32String, // might be null
-    unsigned short output_bip32_pathString_length
+    uint32_t *output_bip32path
 );
 
+// Reads the 12 bytes `account || change || address index` at the start of
+// `data_buffer`, writing the path `44'/536'/account'/change/address_index`
+// (5 components) into `output_bip32path`. Returns `SW_INVALID_PARAM` if
+// `change` is neither 0 nor 1.
+status_word_t parse_bip32_path_from_apdu_command(
+    uint8_t *data_buffer,
+    uint32_t *output_bip32path
+);
+
+// Wipes the cached parent node (`44'/536'/account'/change`) used to speed up
+// derivation of public keys, call on app exit.
+void clear_parent_node_cache(void);
+
 // derive_radix_key_pair derives a key pair from a BIP32 path and the Ledger
 // seed. Returns the public key and private key if not NULL.
 bool derive_radix_key_pair_should_compress(
@@ -16,17 +30,42 @@ bool derive_radix_key_pair_should_compress(
     volatile cx_ecfp_private_key_t *private_key_nullable,
     bool should_compress_pub_key);
 
+// derive_extended_public_key derives the compressed public key and chain code
+// of the node at the first `number_of_bip32_components` components of
+// `bip32path`, together with the BIP32 fingerprint of its parent node.
+bool derive_extended_public_key(
+    uint32_t *bip32path,
+    unsigned int number_of_bip32_components,
+    cx_ecfp_public_key_t *public_key,
+    uint8_t *chain_code,
+    uint8_t *parent_fingerprint
+);
+
 bool derive_radix_key_pair(
     uint32_t *bip32path,
     volatile cx_ecfp_public_key_t *public_key_nullable,
                            volatile cx_ecfp_private_key_t *private_key_nullable);
 
+// Signs `hash` (32 bytes) with `private_key`, writing the 64 bytes signature
+// `r || s` into `output_signature`. Returns the length of the signature, or 0
+// if signing failed. Zeroing out `private_key` is the caller's responsibility.
+size_t sign_hash_move_to_buffer(
+    cx_ecfp_private_key_t *private_key,
+    const uint8_t *hash,
+    uint8_t *output_signature
+);
+
+// Derives the key at `bip32path` and signs `hash` with it, writing the 64
+// bytes signature `r || s` at the start of G_io_apdu_buffer. Returns the
+// length of the signature, or 0 if deriving or signing failed.
 size_t derive_sign_move_to_global_buffer(
     uint32_t *bip32path, 
     const uint8_t *hash
 );
 
-void compress_public_key(cx_ecfp_public_key_t *public_key);
+// Compresses the uncompressed `public_key` in place, returns false if it is
+// not an uncompressed public key.
+bool compress_public_key(cx_ecfp_public_key_t *public_key);
 
 void uncompress_public_key(
     uint8_t *compressed_pubkey,
@@ -4,9 +4,16 @@
 
 #include "global_state.h"
 #include "glyphs.h"
+#include "key_and_signatures.h"
+#include "input_chain.h"
+#include "scratch.h"
+#include "stack_usage.h"
+#include "stats.h"
+#include "trace.h"
 #include "ui.h"
 
-command_context_u global;
+command_context_t global;
+output_queue_t output_queue;
 ux_state_t ux;
 
 static const ux_menu_entry_t menu_main[];
@@ -32,10 +39,16 @@ static const ux_menu_entry_t menu_about[] = {
     UX_MENU_END,
 };
 
+// Wipes the cached parent node before leaving the app, like `app_exit`.
+static void quit_app(unsigned int userid) {
+    clear_parent_node_cache();
+    os_sched_exit(userid);
+}
+
 static const ux_menu_entry_t menu_main[] = {
     {NULL, NULL, 0, NULL, "Waiting for", "commands...", 0, 0},
     {menu_about, NULL, 0, NULL, "About", NULL, 0, 0},
-    {NULL, os_sched_exit, 0, &C_icon_dashboard, "Quit app", NULL, 50, 29},
+    {NULL, quit_app, 0, &C_icon_dashboard, "Quit app", NULL, 50, 29},
     UX_MENU_END,
 };
 
@@ -46,26 +59,67 @@ void ui_idle(void) { UX_MENU_DISPLAY(0, menu_main, NULL); }
 // conventional name for the size of the response APDU, i.e. the write-offset
 // within G_io_apdu_buffer.
 void io_exchange_with_code(uint16_t code, uint16_t tx) {
+    bool is_error = code != SW_OK && (code & 0xFF00) != SW_MORE_DATA_AVAILABLE;
+    stats_end_instruction(is_error);
+    TRACE(TRACE_EVENT_INSTRUCTION_END, code, tx);
     G_io_apdu_buffer[tx++] = code >> 8;
     G_io_apdu_buffer[tx++] = code & 0xFF;
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
 }
 
+// Sends the next (at most `MAX_CHUNK_SIZE`) bytes of the output queue, with
+// status word `SW_MORE_DATA_AVAILABLE` as long as bytes remain.
+static void io_exchange_next_chunk_of_output_queue(void) {
+    uint16_t chunk_length = output_queue.length;
+    if (chunk_length > MAX_CHUNK_SIZE) {
+        chunk_length = MAX_CHUNK_SIZE;
+    }
+    os_memmove(G_io_apdu_buffer, output_queue.data, chunk_length);
+    output_queue.data += chunk_length;
+    output_queue.length -= chunk_length;
+
+    uint16_t code = SW_OK;
+    if (output_queue.length > 0) {
+        code = SW_MORE_DATA_AVAILABLE | (output_queue.length > 0xFF ? 0xFF : output_queue.length);
+    } else {
+        output_queue.data = NULL;
+    }
+    io_exchange_with_code(code, chunk_length);
+}
+
+void io_exchange_with_chained_data(const uint8_t *data, uint16_t length) {
+    output_queue.data = data;
+    output_queue.length = length;
+    io_exchange_next_chunk_of_output_queue();
+}
+
 // The APDU protocol uses a single-byte instruction code (INS) to specify
 // which command should be executed. We'll use this code to dispatch on a
 // table of function pointers.
 #define INS_PING 0x00
 #define INS_GET_VERSION 0x01
 #define INS_GET_PUBLIC_KEY 0x02
+#define INS_GET_PUBLIC_KEYS 0x03
 #define INS_KEY_EXCHANGE 0x04
+#define INS_GET_EXTENDED_PUBLIC_KEY 0x05
 #define INS_SIGN_HASH 0x08
+#define INS_SIGN_HASHES 0x09
+#define INS_SIGN_HASH_MULTI_PATH 0x0A
 #define INS_SIGN_TX 0x16
+#define INS_RESUME_SIGN_TX 0x17
+#define INS_GET_STATS 0x30
+#define INS_GET_STACK_USAGE 0x31
+#define INS_GET_TRACE 0x32
+#define INS_GET_MORE_DATA 0xC0
 
 // This is the function signature for a command handler. 'flags' and 'tx' are
 // out-parameters that will control the behavior of the next io_exchange call
 // in radix_main. It's common to set *flags |= IO_ASYNC_REPLY, but tx is
 // typically unused unless the handler is immediately sending a response APDU.
-typedef void handler_fn_t(uint8_t p1, uint8_t p2, uint8_t *data_buffer,
+// A handler returns `SW_OK` once it has responded (or will respond after
+// review), otherwise the status word the command fails with, without having
+// responded.
+typedef status_word_t handler_fn_t(uint8_t p1, uint8_t p2, uint8_t *data_buffer,
                           uint16_t data_length, volatile unsigned int *flags,
                           volatile unsigned int *tx);
 
@@ -73,9 +127,48 @@ typedef void handler_fn_t(uint8_t p1, uint8_t p2, uint8_t *data_buffer,
 handler_fn_t handle_ping;
 handler_fn_t handle_get_version;
 handler_fn_t handle_get_public_key;
+handler_fn_t handle_get_public_keys;
 handler_fn_t handle_key_exchange;
+handler_fn_t handle_get_extended_public_key;
 handler_fn_t handle_sign_hash;
+handler_fn_t handle_sign_hashes;
+handler_fn_t handle_sign_hash_multi_path;
 handler_fn_t handle_sign_tx;
+handler_fn_t handle_resume_sign_tx;
+handler_fn_t handle_get_stats;
+#ifdef HAVE_STACK_USAGE
+handler_fn_t handle_get_stack_usage;
+#endif
+#ifdef HAVE_TRACE
+handler_fn_t handle_get_trace;
+#endif
+
+// handle_get_more_data responds with the next chunk of a response larger than
+// one APDU, see `io_exchange_with_chained_data`.
+static status_word_t handle_get_more_data(uint8_t p1, uint8_t p2, uint8_t *data_buffer,
+                                          uint16_t data_length, volatile unsigned int *flags,
+                                          volatile unsigned int *tx) {
+    PRINTF("Handle instruction 'GET_MORE_DATA' from host machine.\n");
+    if (output_queue.length == 0) {
+        PRINTF("No more data to respond with.\n");
+        return SW_INVALID_PARAM;
+    }
+    io_exchange_next_chunk_of_output_queue();
+    return SW_OK;
+}
+
+// Upper bound of the total input of commands whose input is chained over
+// several APDUs (see `input_chain.h`), 0 for commands taking a single APDU.
+static uint32_t max_chained_input_length(uint8_t ins) {
+    switch (ins) {
+        case INS_SIGN_HASHES:
+            return MAX_SIGN_HASHES_INPUT_LENGTH;
+        case INS_SIGN_TX:
+            return MAX_SIGN_TX_INPUT_LENGTH;
+        default:
+            return 0;
+    }
+}
 
 static handler_fn_t *lookupHandler(uint8_t ins) {
     switch (ins) {
@@ -85,24 +178,130 @@ static handler_fn_t *lookupHandler(uint8_t ins) {
             return handle_get_version;
         case INS_GET_PUBLIC_KEY:
             return handle_get_public_key;
+        case INS_GET_PUBLIC_KEYS:
+            return handle_get_public_keys;
         case INS_KEY_EXCHANGE:
             return handle_key_exchange;
+        case INS_GET_EXTENDED_PUBLIC_KEY:
+            return handle_get_extended_public_key;
         case INS_SIGN_HASH:
             return handle_sign_hash;
+        case INS_SIGN_HASHES:
+            return handle_sign_hashes;
+        case INS_SIGN_HASH_MULTI_PATH:
+            return handle_sign_hash_multi_path;
         case INS_SIGN_TX:
             return handle_sign_tx;
+        case INS_RESUME_SIGN_TX:
+            return handle_resume_sign_tx;
+        case INS_GET_STATS:
+            return handle_get_stats;
+#ifdef HAVE_STACK_USAGE
+        case INS_GET_STACK_USAGE:
+            return handle_get_stack_usage;
+#endif
+#ifdef HAVE_TRACE
+        case INS_GET_TRACE:
+            return handle_get_trace;
+#endif
+        case INS_GET_MORE_DATA:
+            return handle_get_more_data;
         default:
             return NULL;
     }
 }
 
+#define NO_PREVIOUS_INS 0xFFFF
+
+// INS of the last command, kept across resets of the connection (which
+// restart `radix_main`) so an interrupted upload can be resumed. Set to
+// `NO_PREVIOUS_INS` at boot.
+static uint16_t previous_ins;
+
+// Commands spanning multiple APDUs keep their state in `global`, never let a
+// command see the state of another. The only commands sharing state are
+// signTx and resumeSignTx, which continues an interrupted signTx.
+static bool should_clear_global_state(uint8_t ins) {
+    if (ins == previous_ins) {
+        return false;
+    }
+    bool is_sign_tx_or_resume = ins == INS_SIGN_TX || ins == INS_RESUME_SIGN_TX;
+    bool was_sign_tx_or_resume = previous_ins == INS_SIGN_TX || previous_ins == INS_RESUME_SIGN_TX;
+    return !(is_sign_tx_or_resume && was_sign_tx_or_resume);
+}
+
+// Ends the current command with the error status word `sw`, appended at
+// offset `tx` of G_io_apdu_buffer, returning the length of the response.
+static unsigned int append_error_status_word(uint16_t sw, unsigned int tx) {
+    print_error_by_code(sw);
+
+    // A failed command can't be continued.
+    input_chain_reset();
+    stats_end_instruction(true);
+    TRACE(TRACE_EVENT_INSTRUCTION_END, sw, 0);
+
+    G_io_apdu_buffer[tx++] = sw >> 8;
+    G_io_apdu_buffer[tx++] = sw & 0xFF;
+    return tx;
+}
+
+// Looks up the handler of the command received in G_io_apdu_buffer and calls
+// it on the APDU payload, returning the status word the command failed with,
+// or `SW_OK`. The handler may set the 'flags' and 'tx' variables, which
+// affect the subsequent io_exchange call.
+static status_word_t dispatch_command(volatile unsigned int *flags, volatile unsigned int *tx) {
+    // Malformed APDU.
+    if (G_io_apdu_buffer[OFFSET_CLA] != CLA) {
+        return SW_INCORRECT_CLA;
+    }
+    // Lookup and call the requested command handler.
+    handler_fn_t *handlerFn =
+        lookupHandler(G_io_apdu_buffer[OFFSET_INS]);
+    if (!handlerFn) {
+        return SW_INVALID_INSTRUCTION;
+    }
+    stats_begin_instruction(G_io_apdu_buffer[OFFSET_INS]);
+    stack_usage_begin_instruction(G_io_apdu_buffer[OFFSET_INS]);
+    TRACE(
+        TRACE_EVENT_INSTRUCTION_BEGIN,
+        G_io_apdu_buffer[OFFSET_INS],
+        G_io_apdu_buffer[OFFSET_P1] << 8 | G_io_apdu_buffer[OFFSET_P2]
+    );
+    // Reading the rest of a response continues the previous
+    // command, any other command discards the rest.
+    if (G_io_apdu_buffer[OFFSET_INS] != INS_GET_MORE_DATA) {
+        explicit_bzero(&output_queue, sizeof(output_queue));
+        if (should_clear_global_state(G_io_apdu_buffer[OFFSET_INS])) {
+            explicit_bzero(&global, sizeof(global));
+            input_chain_reset();
+        }
+        previous_ins = G_io_apdu_buffer[OFFSET_INS];
+    }
+    uint32_t max_input_length = max_chained_input_length(G_io_apdu_buffer[OFFSET_INS]);
+    if (max_input_length > 0) {
+        status_word_t sw = input_chain_receive(
+            G_io_apdu_buffer[OFFSET_INS],
+            G_io_apdu_buffer[OFFSET_P1],
+            G_io_apdu_buffer + OFFSET_CDATA,
+            G_io_apdu_buffer[OFFSET_LC],
+            max_input_length
+        );
+        if (sw != SW_OK) {
+            return sw;
+        }
+    }
+    reset_ui();
+    return handlerFn(G_io_apdu_buffer[OFFSET_P1],
+                     G_io_apdu_buffer[OFFSET_P2],
+                     G_io_apdu_buffer + OFFSET_CDATA,
+                     G_io_apdu_buffer[OFFSET_LC], flags, tx);
+}
+
 // This is the main loop that reads and writes APDUs. It receives request
-// APDUs from the computer, looks up the corresponding command handler, and
-// calls it on the APDU payload. Then it loops around and calls io_exchange
-// again. The handler may set the 'flags' and 'tx' variables, which affect the
-// subsequent io_exchange call. The handler may also throw an exception, which
-// will be caught, converted to an error code, appended to the response APDU,
-// and sent in the next io_exchange call.
+// APDUs from the computer, dispatches them to their command handler, and
+// loops around and calls io_exchange again. A handler failing returns the
+// error status word, which is appended to the response APDU and sent in the
+// next io_exchange call.
 static void radix_main(void) {
     volatile unsigned int rx = 0;
     volatile unsigned int tx = 0;
@@ -112,42 +311,39 @@ static void radix_main(void) {
     for (;;) {
         volatile unsigned short sw = 0;
 
-        // The Ledger SDK implements a form of exception handling. In addition
-        // to explicit THROWs in user code, syscalls (prefixed with os_ or
-        // cx_) may also throw exceptions.
+        // The Ledger SDK implements a form of exception handling. Commands
+        // report errors by returning them, but syscalls (prefixed with os_ or
+        // cx_) may throw exceptions, and so do violated assertions.
         //
         // In radix_main, this TRY block serves to catch any thrown exceptions
         // and convert them to response codes, which are then sent in APDUs.
-        // However, EXCEPTION_IO_RESET will be re-thrown and caught by the
-        // "true" main function defined at the bottom of this file.
+        // Entering it saves the execution context, so it is only entered
+        // again after an exception rather than for every APDU. However,
+        // EXCEPTION_IO_RESET will be re-thrown and caught by the "true" main
+        // function defined at the bottom of this file.
         BEGIN_TRY {
             TRY {
-                rx = tx;
-                tx = 0;  // ensure no race in CATCH_OTHER if io_exchange throws
-                         // an error
-                rx = io_exchange(CHANNEL_APDU | flags, rx);
-
-                flags = 0;
-
-                // No APDU received; trigger a reset.
-                if (rx == 0) {
-                    THROW(EXCEPTION_IO_RESET);
-                }
-                // Malformed APDU.
-                if (G_io_apdu_buffer[OFFSET_CLA] != CLA) {
-                    THROW(SW_INCORRECT_CLA);
-                }
-                // Lookup and call the requested command handler.
-                handler_fn_t *handlerFn =
-                    lookupHandler(G_io_apdu_buffer[OFFSET_INS]);
-                if (!handlerFn) {
-                    THROW(SW_INVALID_INSTRUCTION);
+                for (;;) {
+                    rx = tx;
+                    tx = 0;  // ensure no race in CATCH_OTHER if io_exchange
+                             // throws an error
+                    rx = io_exchange(CHANNEL_APDU | flags, rx);
+
+                    // The previous command is done, including its review.
+                    stack_usage_end_instruction();
+
+                    flags = 0;
+
+                    // No APDU received; trigger a reset.
+                    if (rx == 0) {
+                        THROW(EXCEPTION_IO_RESET);
+                    }
+                    status_word_t command_sw = dispatch_command(&flags, &tx);
+                    if (command_sw != SW_OK) {
+                        PRINTF("main.c command failed: %d\n", command_sw);
+                        tx = append_error_status_word(command_sw, 0);
+                    }
                 }
-                reset_ui();
-                handlerFn(G_io_apdu_buffer[OFFSET_P1],
-                          G_io_apdu_buffer[OFFSET_P2],
-                          G_io_apdu_buffer + OFFSET_CDATA,
-                          G_io_apdu_buffer[OFFSET_LC], &flags, &tx);
             }
             CATCH(EXCEPTION_IO_RESET) {
                 PLOC();
@@ -165,8 +361,6 @@ static void radix_main(void) {
                 // codes?
                 PRINTF("main.c error: %d\n", e);
 
-                print_error_by_code(e);
-
                 // Cyon: I have no what these bit masks do/come from. e.g. `(e & 0x7FF)`, is this documented somewhere? This is inherited from sia app... ( https://github.com/LedgerHQ/app-sia/blob/master/src/main.c )
                 switch (e & 0xF000) {
                     case 0x6000:
@@ -177,8 +371,9 @@ static void radix_main(void) {
                         sw = 0x6800 | (e & 0x7FF);
                         break;
                 }
-                G_io_apdu_buffer[tx++] = sw >> 8;
-                G_io_apdu_buffer[tx++] = sw & 0xFF;
+                // Helpers thrown out of never released their temporaries.
+                scratch_reset();
+                tx = append_error_status_word(sw, tx);
             }
             FINALLY {}
         }
@@ -226,6 +421,7 @@ unsigned char io_event(unsigned char channel) {
             break;
 
         case SEPROXYHAL_TAG_TICKER_EVENT:
+            stats_did_tick();
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {});
             break;
 
@@ -268,6 +464,7 @@ unsigned short io_exchange_al(unsigned char channel, unsigned short tx_len) {
 }
 
 static void app_exit(void) {
+    clear_parent_node_cache();
     BEGIN_TRY_L(exit) {
         TRY_L(exit) { os_sched_exit(-1); }
         FINALLY_L(exit) {}
@@ -289,6 +486,11 @@ int main(void) {
     __asm volatile("cpsie i");
 #endif
 
+    clear_parent_node_cache();
+    previous_ins = NO_PREVIOUS_INS;
+    explicit_bzero(&output_queue, sizeof(output_queue));
+    stack_usage_init();
+
     for (;;) {
         UX_INIT();
         os_boot();
@@ -0,0 +1,27 @@
+#include "scratch.h"
+#include <os.h>
+#include "common_macros.h"
+#include "global_state.h"
+
+static scratch_arena_t *arena = &global.scratch;
+
+scratch_mark_t scratch_mark(void) {
+    return arena->used;
+}
+
+uint8_t *scratch_alloc(size_t byte_count) {
+    assert(byte_count <= SCRATCH_ARENA_BYTE_COUNT - arena->used);
+    uint8_t *allocation = arena->bytes + arena->used;
+    arena->used += byte_count;
+    return allocation;
+}
+
+void scratch_release(scratch_mark_t mark) {
+    assert(mark <= arena->used);
+    explicit_bzero(arena->bytes + mark, arena->used - mark);
+    arena->used = mark;
+}
+
+void scratch_reset(void) {
+    scratch_release(0);
+}
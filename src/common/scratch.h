@@ -0,0 +1,42 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Size of the scratch arena, the most temporaries live at once are those of
+// displaying an address: its bech32 string (66 bytes) and the 5 bit groups
+// it is encoded from (55 bytes).
+#define SCRATCH_ARENA_BYTE_COUNT 128
+
+// Bump allocated buffer for temporaries of helpers, too large for the stack,
+// kept in `global` next to the context of the command.
+typedef struct {
+    uint16_t used;
+    uint8_t bytes[SCRATCH_ARENA_BYTE_COUNT];
+} scratch_arena_t;
+
+typedef uint16_t scratch_mark_t;
+
+// Helpers take their temporaries from the arena within a scope:
+//
+//     scratch_mark_t mark = scratch_mark();
+//     uint8_t *temporary = scratch_alloc(byte_count);
+//     ...
+//     scratch_release(mark);
+//
+// Releasing zeroes everything allocated since `mark`, so temporaries derived
+// from sensitive data don't outlive their scope.
+scratch_mark_t scratch_mark(void);
+
+// Returns `byte_count` bytes (not aligned, meant for byte buffers), asserts
+// that they fit in what is left of the arena.
+uint8_t *scratch_alloc(size_t byte_count);
+
+void scratch_release(scratch_mark_t mark);
+
+// Releases everything, for the dispatcher to recover the scopes left by an
+// exception.
+void scratch_reset(void);
+
+#endif
@@ -0,0 +1,110 @@
+#include "stack_usage.h"
+
+#ifdef HAVE_STACK_USAGE
+
+#include <os.h>
+#include "common_macros.h"
+
+// The stack grows down towards `app_stack_canary`, the lowest word of the
+// stack, placed there by the SDK linker script.
+extern unsigned int app_stack_canary;
+
+#define STACK_PAINT 0xA5A5A5A5
+
+// Words below the frame of `paint_stack` left unpainted, for the registers
+// it pushes.
+#define STACK_PAINT_MARGIN_WORDS 8
+
+#define STACK_USAGE_NO_INSTRUCTION 0xFFFF
+
+typedef struct {
+    uint8_t ins;
+    uint16_t lowest_free_byte_count;
+} instruction_stack_usage_t;
+
+static uint8_t number_of_instructions;
+static instruction_stack_usage_t instructions[STACK_USAGE_MAX_NUMBER_OF_INSTRUCTIONS];
+
+// Instruction in flight, if any.
+static uint16_t current_ins;
+
+// Bytes between the bottom of the stack and the frame painting it.
+static uint16_t paintable_byte_count;
+
+static uint32_t *stack_bottom(void) {
+    // Leave the canary itself alone.
+    return &app_stack_canary + 1;
+}
+
+static void paint_stack(void) {
+    volatile uint32_t marker;
+    uint32_t *end = (uint32_t *) &marker - STACK_PAINT_MARGIN_WORDS;
+    for (uint32_t *word = stack_bottom(); word < end; ++word) {
+        *word = STACK_PAINT;
+    }
+    paintable_byte_count = (uint8_t *) end - (uint8_t *) stack_bottom();
+}
+
+static uint16_t free_byte_count(void) {
+    uint32_t *word = stack_bottom();
+    uint32_t *end = word + paintable_byte_count / sizeof(uint32_t);
+    while (word < end && *word == STACK_PAINT) {
+        ++word;
+    }
+    return (uint8_t *) word - (uint8_t *) stack_bottom();
+}
+
+static instruction_stack_usage_t *stack_usage_of_instruction(uint8_t ins) {
+    for (uint8_t i = 0; i < number_of_instructions; ++i) {
+        if (instructions[i].ins == ins) {
+            return &instructions[i];
+        }
+    }
+    if (number_of_instructions == STACK_USAGE_MAX_NUMBER_OF_INSTRUCTIONS) {
+        return NULL;
+    }
+    instruction_stack_usage_t *instruction = &instructions[number_of_instructions++];
+    instruction->ins = ins;
+    instruction->lowest_free_byte_count = UINT16_MAX;
+    return instruction;
+}
+
+void stack_usage_init(void) {
+    number_of_instructions = 0;
+    current_ins = STACK_USAGE_NO_INSTRUCTION;
+    paint_stack();
+}
+
+void stack_usage_begin_instruction(uint8_t ins) {
+    current_ins = ins;
+    paint_stack();
+}
+
+void stack_usage_end_instruction(void) {
+    if (current_ins == STACK_USAGE_NO_INSTRUCTION) {
+        return;
+    }
+    uint16_t free_bytes = free_byte_count();
+    PRINTF("Stack usage: INS 0x%02x left %d untouched bytes\n", current_ins, free_bytes);
+    instruction_stack_usage_t *instruction = stack_usage_of_instruction(current_ins);
+    current_ins = STACK_USAGE_NO_INSTRUCTION;
+    if (instruction && free_bytes < instruction->lowest_free_byte_count) {
+        instruction->lowest_free_byte_count = free_bytes;
+    }
+}
+
+uint16_t write_stack_usage(uint8_t *buffer) {
+    uint16_t offset = 0;
+    buffer[offset++] = STACK_USAGE_LAYOUT_VERSION;
+    buffer[offset++] = number_of_instructions;
+    buffer[offset++] = paintable_byte_count >> 8;
+    buffer[offset++] = paintable_byte_count & 0xFF;
+    for (uint8_t i = 0; i < number_of_instructions; ++i) {
+        buffer[offset++] = instructions[i].ins;
+        buffer[offset++] = instructions[i].lowest_free_byte_count >> 8;
+        buffer[offset++] = instructions[i].lowest_free_byte_count & 0xFF;
+    }
+    return offset;
+}
+
+#endif // HAVE_STACK_USAGE
@@ -0,0 +1,46 @@
+#ifndef STACK_USAGE_H
+#define STACK_USAGE_H
+
+#include <stdint.h>
+
+// Stack usage measurement, built with `make STACK_USAGE=1`. The free part of
+// the stack is painted with a known pattern before each command, the number
+// of bytes still holding the pattern once the command is done is how close
+// it came to overflowing the stack.
+
+#ifdef HAVE_STACK_USAGE
+
+// Distinct instructions kept track of, more than the app has.
+#define STACK_USAGE_MAX_NUMBER_OF_INSTRUCTIONS 16
+
+// Version of the layout written by `write_stack_usage`.
+#define STACK_USAGE_LAYOUT_VERSION 1
+
+// Paints the free part of the stack, call once at boot.
+void stack_usage_init(void);
+
+// Called by the dispatcher once a command has been received, before its
+// handler runs, and when the next command is received, after everything the
+// previous one did (including review and work done between exchanges).
+void stack_usage_begin_instruction(uint8_t ins);
+void stack_usage_end_instruction(void);
+
+// Writes the stack usage into `buffer`, returning the number of bytes
+// written:
+//
+// - layout version (1 byte), number of instructions N (1 byte), bytes
+//   between the bottom of the stack and the dispatcher's frame (2 bytes)
+// - N times: INS (1 byte), lowest number of untouched bytes (2 bytes)
+//
+// All integers big endian.
+uint16_t write_stack_usage(uint8_t *buffer);
+
+#else
+
+static inline void stack_usage_init(void) {}
+static inline void stack_usage_begin_instruction(uint8_t ins) { (void) ins; }
+static inline void stack_usage_end_instruction(void) {}
+
+#endif // HAVE_STACK_USAGE
+
+#endif // STACK_USAGE_H
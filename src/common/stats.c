@@ -0,0 +1,113 @@
+#include "stats.h"
+#include <os.h>
+#include "common_macros.h"
+
+// Largest number of bytes written by `write_stats`.
+#define STATS_MAX_BYTE_COUNT (6 + 4 * STATS_NUMBER_OF_OPERATIONS + 11 * STATS_MAX_NUMBER_OF_INSTRUCTIONS)
+
+typedef struct {
+    uint8_t ins;
+    uint16_t count;
+    uint16_t error_count;
+    uint32_t total_ticks;
+    uint16_t max_ticks;
+} instruction_stats_t;
+
+typedef struct {
+    uint8_t number_of_instructions;
+    instruction_stats_t instructions[STATS_MAX_NUMBER_OF_INSTRUCTIONS];
+    uint32_t operation_counts[STATS_NUMBER_OF_OPERATIONS];
+
+    // Instruction in flight, if any.
+    instruction_stats_t *current;
+    uint32_t ticks_at_begin;
+} stats_t;
+
+static volatile uint32_t ticks;
+static stats_t stats;
+
+void stats_did_tick(void) {
+    ticks++;
+}
+
+uint32_t stats_ticks(void) {
+    return ticks;
+}
+
+static instruction_stats_t *stats_of_instruction(uint8_t ins) {
+    for (uint8_t i = 0; i < stats.number_of_instructions; ++i) {
+        if (stats.instructions[i].ins == ins) {
+            return &stats.instructions[i];
+        }
+    }
+    if (stats.number_of_instructions == STATS_MAX_NUMBER_OF_INSTRUCTIONS) {
+        return NULL;
+    }
+    instruction_stats_t *instruction = &stats.instructions[stats.number_of_instructions++];
+    instruction->ins = ins;
+    return instruction;
+}
+
+void stats_begin_instruction(uint8_t ins) {
+    stats.current = stats_of_instruction(ins);
+    stats.ticks_at_begin = ticks;
+}
+
+void stats_end_instruction(bool is_error) {
+    instruction_stats_t *instruction = stats.current;
+    if (!instruction) {
+        return;
+    }
+    stats.current = NULL;
+
+    uint32_t elapsed_ticks = ticks - stats.ticks_at_begin;
+    if (instruction->count < UINT16_MAX) {
+        instruction->count++;
+    }
+    if (is_error && instruction->error_count < UINT16_MAX) {
+        instruction->error_count++;
+    }
+    if (instruction->total_ticks <= UINT32_MAX - elapsed_ticks) {
+        instruction->total_ticks += elapsed_ticks;
+    }
+    if (elapsed_ticks > instruction->max_ticks) {
+        instruction->max_ticks = elapsed_ticks > UINT16_MAX ? UINT16_MAX : elapsed_ticks;
+    }
+}
+
+void stats_count_operation(stats_operation_t operation) {
+    if (stats.operation_counts[operation] < UINT32_MAX) {
+        stats.operation_counts[operation]++;
+    }
+}
+
+static uint16_t write_u16(uint8_t *buffer, uint16_t offset, uint16_t value) {
+    buffer[offset] = value >> 8;
+    buffer[offset + 1] = value & 0xFF;
+    return offset + 2;
+}
+
+static uint16_t write_u32(uint8_t *buffer, uint16_t offset, uint32_t value) {
+    WRITE_U4BE(buffer, offset, value);
+    return offset + 4;
+}
+
+uint16_t write_stats(uint8_t *buffer) {
+    uint16_t offset = 0;
+    buffer[offset++] = STATS_LAYOUT_VERSION;
+    buffer[offset++] = stats.number_of_instructions;
+    offset = write_u32(buffer, offset, ticks);
+    for (int i = 0; i < STATS_NUMBER_OF_OPERATIONS; ++i) {
+        offset = write_u32(buffer, offset, stats.operation_counts[i]);
+    }
+    for (uint8_t i = 0; i < stats.number_of_instructions; ++i) {
+        instruction_stats_t *instruction = &stats.instructions[i];
+        buffer[offset++] = instruction->ins;
+        offset = write_u16(buffer, offset, instruction->count);
+        offset = write_u16(buffer, offset, instruction->error_count);
+        offset = write_u32(buffer, offset, instruction->total_ticks);
+        offset = write_u16(buffer, offset, instruction->max_ticks);
+    }
+    assert(offset <= STATS_MAX_BYTE_COUNT);
+    return offset;
+}
@@ -0,0 +1,46 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Distinct instructions kept track of, more than the app has.
+#define STATS_MAX_NUMBER_OF_INSTRUCTIONS 16
+
+// Version of the layout written by `write_stats`.
+#define STATS_LAYOUT_VERSION 1
+
+typedef enum {
+    STATS_OPERATION_DERIVATION = 0,
+    STATS_OPERATION_SIGNING,
+    STATS_OPERATION_ECDH,
+    STATS_NUMBER_OF_OPERATIONS,
+} stats_operation_t;
+
+// Called by the event loop for every ticker event (one every 100 ms).
+void stats_did_tick(void);
+
+// Ticker events received since boot.
+uint32_t stats_ticks(void);
+
+// Called by the dispatcher once a command has been received, and when its
+// response is sent (which for commands asking the user to review happens
+// long after the handler has returned). Ending when no instruction is in
+// flight does nothing.
+void stats_begin_instruction(uint8_t ins);
+void stats_end_instruction(bool is_error);
+
+void stats_count_operation(stats_operation_t operation);
+
+// Writes the stats into `buffer`, returning the number of bytes written:
+//
+// - layout version (1 byte), number of instructions N (1 byte), ticks
+//   since boot (4 bytes)
+// - number of derivations, signatures and ECDH operations (4 bytes each)
+// - N times: INS (1 byte), count (2 bytes), errors (2 bytes), total ticks
+//   (4 bytes), max ticks (2 bytes)
+//
+// All integers big endian, counters saturate at their maximum.
+uint16_t write_stats(uint8_t *buffer);
+
+#endif
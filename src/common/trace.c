@@ -0,0 +1,60 @@
+#include "trace.h"
+
+#ifdef HAVE_TRACE
+
+#include <os.h>
+#include "common_macros.h"
+#include "stats.h"
+
+typedef struct {
+    uint32_t arg0;
+    uint32_t arg1;
+    uint16_t tick;
+    uint8_t event;
+} trace_record_t;
+
+static trace_record_t records[TRACE_NUMBER_OF_RECORDS];
+
+#define TRACE_RECORD_INDEX_MASK (TRACE_NUMBER_OF_RECORDS - 1)
+
+// Number of events ever recorded, the next one goes into
+// `records[number_of_events_recorded & TRACE_RECORD_INDEX_MASK]`.
+static uint32_t number_of_events_recorded;
+
+void trace_record(trace_event_t event, uint32_t arg0, uint32_t arg1) {
+    trace_record_t *record = &records[number_of_events_recorded & TRACE_RECORD_INDEX_MASK];
+    record->arg0 = arg0;
+    record->arg1 = arg1;
+    record->tick = stats_ticks();
+    record->event = event;
+    number_of_events_recorded++;
+}
+
+uint16_t write_trace(uint8_t *buffer) {
+    uint8_t number_of_records = number_of_events_recorded < TRACE_NUMBER_OF_RECORDS
+        ? number_of_events_recorded
+        : TRACE_NUMBER_OF_RECORDS;
+
+    uint16_t offset = 0;
+    buffer[offset++] = TRACE_LAYOUT_VERSION;
+    WRITE_U4BE(buffer, offset, number_of_events_recorded);
+    offset += 4;
+    buffer[offset++] = number_of_records;
+    for (uint32_t i = number_of_events_recorded - number_of_records; i < number_of_events_recorded; ++i) {
+        trace_record_t *record = &records[i & TRACE_RECORD_INDEX_MASK];
+        buffer[offset++] = record->event;
+        buffer[offset++] = record->tick >> 8;
+        buffer[offset++] = record->tick & 0xFF;
+        WRITE_U4BE(buffer, offset, record->arg0);
+        offset += 4;
+        WRITE_U4BE(buffer, offset, record->arg1);
+        offset += 4;
+    }
+    return offset;
+}
+
+void trace_clear(void) {
+    number_of_events_recorded = 0;
+}
+
+#endif // HAVE_TRACE
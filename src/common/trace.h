@@ -0,0 +1,59 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Binary trace of what the app does, built with `make TRACE=1`. Unlike
+// PRINTF, recording an event only stores a few words in RAM, so it barely
+// changes the timing of what is traced. The most recent events are read
+// with the GET_TRACE command, `tools/decode_trace.py` turns them into a
+// timeline.
+
+typedef enum {
+    TRACE_EVENT_INSTRUCTION_BEGIN = 1, // INS, P1 << 8 | P2
+    TRACE_EVENT_INSTRUCTION_END,       // status word, response length
+    TRACE_EVENT_DERIVATION_BEGIN,      // number of BIP32 components, last component
+    TRACE_EVENT_DERIVATION_END,        // -, -
+    TRACE_EVENT_SIGNING_BEGIN,         // length of hash, -
+    TRACE_EVENT_SIGNING_END,           // result, -
+    TRACE_EVENT_ECDH_BEGIN,            // -, -
+    TRACE_EVENT_ECDH_END,              // length of secret, -
+    TRACE_EVENT_UI_DISPLAY,            // first 4 characters of the title, is seeking
+    TRACE_EVENT_UI_APPROVED,           // -, -
+    TRACE_EVENT_UI_REJECTED,           // -, -
+} trace_event_t;
+
+#ifdef HAVE_TRACE
+
+// Number of most recent events kept, all of them fit into one response. A
+// power of two, so that finding the slot of an event is a mask.
+#define TRACE_NUMBER_OF_RECORDS 16
+
+// Version of the layout written by `write_trace`.
+#define TRACE_LAYOUT_VERSION 1
+
+void trace_record(trace_event_t event, uint32_t arg0, uint32_t arg1);
+
+// Writes the kept events, oldest first, into `buffer`, returning the number
+// of bytes written:
+//
+// - layout version (1 byte), number of events ever recorded (4 bytes),
+//   number of events N (1 byte)
+// - N times: event (1 byte), tick (2 bytes, wrapping), arg0 (4 bytes),
+//   arg1 (4 bytes)
+//
+// All integers big endian.
+uint16_t write_trace(uint8_t *buffer);
+
+// Forgets all events.
+void trace_clear(void);
+
+#define TRACE(event, arg0, arg1) trace_record((event), (arg0), (arg1))
+
+#else
+
+#define TRACE(event, arg0, arg1) do {} while (0)
+
+#endif // HAVE_TRACE
+
+#endif // TRACE_H
@@ -1,6 +1,7 @@
 #include "ui.h"
 #include <os_io_seproxyhal.h>
 #include "common_macros.h"
+#include "trace.h"
 
 
 #define UI_BACKGROUND() {{BAGL_RECTANGLE,0,0,0,128,32,0,0,BAGL_FILL,0,0xFFFFFF,0,0},NULL}
@@ -105,9 +106,10 @@
 
 ui_state_t G_ui_state;
 
-void clear_lower_line_long() {
-    os_memset(G_ui_state.lower_line_long, 0x00, MAX_LENGTH_FULL_STR_DISPLAY);
-    G_ui_state.length_lower_line_long = 0;
+static void clear_lower_line_source() {
+    release_display_source_rendering();
+    explicit_bzero(&G_ui_state.lower_line_source, sizeof(display_source_t));
+    G_ui_state.length_lower_line = 0;
 }
 
 void clear_partialStr() {
@@ -117,18 +119,18 @@ void clear_partialStr() {
 }
 
 void reset_ui() { 
-    clear_lower_line_long();
+    clear_lower_line_source();
     clear_partialStr();
  }
 
-static void ui_fullStr_to_partial() {
-    clear_partialStr();
-
-    os_memmove(G_ui_state.lower_line_short, G_ui_state.lower_line_long,
-               DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE);
-    G_ui_state
-        .lower_line_short[DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE] =
-        '\0';
+// Renders the window of the lower line value at the display offset.
+static void render_lower_line_window() {
+    G_ui_state.length_lower_line = render_display_source_window(
+        &G_ui_state.lower_line_source,
+        G_ui_state.lower_line_display_offset,
+        DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE,
+        G_ui_state.lower_line_short
+    );
 }
 
 static callback_t function_pointer;
@@ -138,11 +140,16 @@ unsigned int reject_or_approve(unsigned int button_mask,
                                callback_t didApproveCallback) {
     switch (button_mask) {
         case BUTTON_EVT_RELEASED | BUTTON_LEFT: {  // REJECT
+            TRACE(TRACE_EVENT_UI_REJECTED, 0, 0);
+            clear_lower_line_source();
             io_exchange_with_code(SW_USER_REJECTED, 0);
             ui_idle();
             break;
         }
         case BUTTON_EVT_RELEASED | BUTTON_RIGHT: {  // Approve
+            TRACE(TRACE_EVENT_UI_APPROVED, 0, 0);
+            // The callback may sign, which needs the scratch arena.
+            clear_lower_line_source();
             didApproveCallback();
             break;
         }
@@ -161,9 +168,7 @@ unsigned int seek_left_right_or_approve(unsigned int button_mask,
             if (G_ui_state.lower_line_display_offset > 0) {
                 G_ui_state.lower_line_display_offset--;
             }
-            os_memmove(G_ui_state.lower_line_short,
-                       G_ui_state.lower_line_long + G_ui_state.lower_line_display_offset,
-                       DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE);
+            render_lower_line_window();
             // Re-render the screen.
             UX_REDISPLAY();
             break;
@@ -171,17 +176,17 @@ unsigned int seek_left_right_or_approve(unsigned int button_mask,
         case BUTTON_RIGHT:
         case BUTTON_EVT_FAST | BUTTON_RIGHT:  // SEEK RIGHT
             if (G_ui_state.lower_line_display_offset <
-                (G_ui_state.length_lower_line_long -
+                (G_ui_state.length_lower_line -
                  DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE)) {
                 G_ui_state.lower_line_display_offset++;
             }
-            os_memmove(G_ui_state.lower_line_short,
-                       G_ui_state.lower_line_long + G_ui_state.lower_line_display_offset,
-                       DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE);
+            render_lower_line_window();
             UX_REDISPLAY();
             break;
 
         case BUTTON_EVT_RELEASED | BUTTON_LEFT | BUTTON_RIGHT:  // PROCEED
+            TRACE(TRACE_EVENT_UI_APPROVED, 0, 0);
+            clear_lower_line_source();
             didApproveCallback();
             break;
     }
@@ -192,7 +197,7 @@ const bagl_element_t *preprocessor_for_seeking(const bagl_element_t *element) {
     if ((element->component.userid == 1 && G_ui_state.lower_line_display_offset == 0) ||
         (element->component.userid == 2 &&
          (G_ui_state.lower_line_display_offset ==
-          (G_ui_state.length_lower_line_long -
+          (G_ui_state.length_lower_line -
            DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE)))) {
         return NULL;
     }
@@ -233,6 +238,7 @@ static unsigned int ui_generic_two_lines_approve_button(
 
 static void display(const char *row_1_max_12_chars,
                     const char *row_2_max_12_chars,
+                    const display_source_t *source,
                     callback_t didApproveCallback) {
     if (!row_1_max_12_chars) {
         FATAL_ERROR("First row cannot be null");
@@ -251,7 +257,18 @@ static void display(const char *row_1_max_12_chars,
     os_memset(title_row_two, 0x00,
               DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE);
 
-    ui_fullStr_to_partial();
+    // A new value may be at the address of the previous one, never show the
+    // rendering of that.
+    clear_lower_line_source();
+    clear_partialStr();
+    os_memcpy(&G_ui_state.lower_line_source, source, sizeof(display_source_t));
+    render_lower_line_window();
+
+    TRACE(
+        TRACE_EVENT_UI_DISPLAY,
+        U4BE((uint8_t *) title_row_one, 0),
+        !row_2_max_12_chars && G_ui_state.length_lower_line > DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE
+    );
 
     if (row_2_max_12_chars) {
         unsigned long length_of_row2 = strlen(row_2_max_12_chars);
@@ -263,7 +280,7 @@ static void display(const char *row_1_max_12_chars,
     } else {
         // single line
 
-        if (G_ui_state.length_lower_line_long >
+        if (G_ui_state.length_lower_line >
             DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE) {
             UX_DISPLAY(ui_generic_single_line_seek, preprocessor_for_seeking);
         } else {
@@ -279,10 +296,12 @@ void display_lines(const char *row_1_max_12_chars,
         FATAL_ERROR("Second row cannot be null");
     }
 
-    display(row_1_max_12_chars, row_2_max_12_chars, didApproveCallback);
+    display_source_t no_value = { .kind = DISPLAY_SOURCE_NONE };
+    display(row_1_max_12_chars, row_2_max_12_chars, &no_value, didApproveCallback);
 }
 
 void display_value(const char *title_max_12_chars,
+                   display_source_t source,
                    callback_t didApproveCallback) {
-    display(title_max_12_chars, NULL, didApproveCallback);
+    display(title_max_12_chars, NULL, &source, didApproveCallback);
 }
@@ -5,18 +5,17 @@
 #include <seproxyhal_protocol.h>
 #include <os_io_seproxyhal.h>
 #include "common_macros.h"
+#include "display_source.h"
 
 // assuming a font size of 11 (`BAGL_FONT_OPEN_SANS_REGULAR_11px`)
 #define DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE 12
 
-// Size of some string used for displaying long text on disaply
-#define MAX_LENGTH_FULL_STR_DISPLAY (2 * PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT)
-
 typedef struct {
-
-	uint8_t lower_line_display_offset;
-    char lower_line_long[MAX_LENGTH_FULL_STR_DISPLAY]; // the RRI is the longest data we wanna display
-	uint8_t length_lower_line_long;
+    // The value displayed on the lower line, of which only the window at
+    // `lower_line_display_offset` is rendered, into `lower_line_short`.
+    display_source_t lower_line_source;
+    uint16_t length_lower_line;
+	uint16_t lower_line_display_offset;
     char lower_line_short[DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE + 1]; //+1 for NULL
 } ui_state_t;
 
@@ -37,19 +36,28 @@ void ui_idle(void);
 // within G_io_apdu_buffer (before the code is appended).
 void io_exchange_with_code(uint16_t code, uint16_t tx);
 
+// io_exchange_with_chained_data sends `length` bytes of `data` as response,
+// which may be more than fit into one response APDU. The first
+// `MAX_CHUNK_SIZE` bytes are sent right away, with status word
+// `SW_MORE_DATA_AVAILABLE`, the rest is read by the host with the
+// GET_MORE_DATA command. `data` must stay valid until then, e.g. by pointing
+// into the context of the command.
+void io_exchange_with_chained_data(const uint8_t *data, uint16_t length);
+
 void display_lines(
 	const char *row_1_max_12_chars,
 	const char *row_2_max_12_chars,
 	callback_t didApproveCallback);
 
+// display_value displays the title above the value of `source`, which the
+// user seeks through if it is longer than a line.
 void display_value(
 	const char *title_max_12_chars,
+	display_source_t source,
 	callback_t didApproveCallback);
 
 void clear_partialStr(void);
 
 void reset_ui(void);
 
-void clear_lower_line_long(void);
-
 #endif
@@ -0,0 +1,90 @@
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include <cx.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common_macros.h"
+#include "global_state.h"
+#include "key_and_signatures.h"
+#include "stringify_bip32_path.h"
+#include "ui.h"
+
+static get_extended_public_key_context_t *ctx = &global.get_extended_public_key_context;
+
+static void generate_and_respond_with_extended_public_key() {
+    cx_ecfp_public_key_t public_key;
+    uint8_t chain_code[CHAIN_CODE_BYTE_COUNT];
+    uint8_t parent_fingerprint[BIP32_FINGERPRINT_BYTE_COUNT];
+
+    if (!derive_extended_public_key(
+        ctx->bip32_path,
+        NUMBER_OF_BIP32_COMPONENTS_IN_ACCOUNT_PATH,
+        &public_key,
+        chain_code,
+        parent_fingerprint
+    )) {
+        PRINTF("Failed to derive extended public key");
+        io_exchange_with_code(SW_INTERNAL_ERROR_ECC, 0);
+        ui_idle();
+        return;
+    }
+    assert(public_key.W_len == PUBLIC_KEY_COMPRESSEED_BYTE_COUNT);
+
+    uint16_t tx = 0;
+    os_memmove(G_io_apdu_buffer + tx, public_key.W, PUBLIC_KEY_COMPRESSEED_BYTE_COUNT);
+    tx += PUBLIC_KEY_COMPRESSEED_BYTE_COUNT;
+    os_memmove(G_io_apdu_buffer + tx, chain_code, CHAIN_CODE_BYTE_COUNT);
+    tx += CHAIN_CODE_BYTE_COUNT;
+    os_memmove(G_io_apdu_buffer + tx, parent_fingerprint, BIP32_FINGERPRINT_BYTE_COUNT);
+    tx += BIP32_FINGERPRINT_BYTE_COUNT;
+
+    io_exchange_with_code(SW_OK, tx);
+    ui_idle();
+}
+
+static void proceed_to_extended_public_key_confirmation() {
+    display_lines("Export xpub", "Confirm?", generate_and_respond_with_extended_public_key);
+}
+
+#define P1_REQUIRE_CONFIRMATION_BEFORE_GENERATION 0x01
+
+// handle_get_extended_public_key is the entry point for the
+// getExtendedPublicKey command. It reads a 4 byte `account` and responds with
+// the compressed public key (33 bytes) and chain code (32 bytes) of the node
+// `44'/536'/account'`, followed by the fingerprint (4 bytes) of its parent
+// node, enabling the host to derive (non-hardened) addresses on its own.
+status_word_t handle_get_extended_public_key(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *data_buffer,
+    uint16_t data_length,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx
+) {
+    PRINTF("Handle instruction 'GET_EXTENDED_PUBLIC_KEY' from host machine.\n");
+    uint16_t byte_count_bip_component = 4;
+    uint16_t expected_data_length = byte_count_bip_component; // account
+
+    if (data_length != expected_data_length) {
+        PRINTF("'data_length' must be: %u, but was: %d\n", expected_data_length,
+               data_length);
+        return SW_INVALID_PARAM;
+    }
+
+    // READ BIP 32 path `44'/536'/account'`
+    parse_bip32_account_path_from_apdu_command(data_buffer, ctx->bip32_path);
+
+    *flags |= IO_ASYNCH_REPLY;
+
+    if (p1 == P1_REQUIRE_CONFIRMATION_BEFORE_GENERATION) {
+        display_value(
+            "Xpub at path",
+            bip32_path_display_source(ctx->bip32_path, NUMBER_OF_BIP32_COMPONENTS_IN_ACCOUNT_PATH),
+            proceed_to_extended_public_key_confirmation
+        );
+    } else {
+        generate_and_respond_with_extended_public_key();
+    }
+    return SW_OK;
+}
@@ -52,17 +52,16 @@ static void generate_and_respond_with_compressed_public_key() {
         
     if (ctx->display_address) {
         
-        clear_lower_line_long();
         explicit_bzero(ctx->address.bytes, RADIX_ADDRESS_BYTE_COUNT);
         
         os_memset(ctx->address.bytes, RADIX_ADDRESS_VERSION_BYTE, RADIX_ADDRESS_VERSION_DATA_LENGTH);
         os_memcpy(ctx->address.bytes + RADIX_ADDRESS_VERSION_DATA_LENGTH, public_key.W, PUBLIC_KEY_COMPRESSEED_BYTE_COUNT);
         
-        size_t actual_radix_address_length = to_string_radix_address(&ctx->address, G_ui_state.lower_line_long, MAX_LENGTH_FULL_STR_DISPLAY);
-
-        G_ui_state.length_lower_line_long = actual_radix_address_length;
-                
-        display_value("Your address", proceed_to_final_address_confirmation);
+        display_value(
+            "Your address",
+            radix_address_display_source(&ctx->address),
+            proceed_to_final_address_confirmation
+        );
     } else {
         finished_ui_flow_respond_with_pubkey();
     }
@@ -81,7 +80,11 @@ static void generate_publickey_require_confirmation_if_needed(
             PRINTF("setting cb = generate_and_respond_with_compressed_public_key\n");
             cb = generate_and_respond_with_compressed_public_key;
         }
-        display_value("Key at index", cb);
+        display_value(
+            "Key at index",
+            bip32_path_display_source(ctx->bip32_path, NUMBER_OF_BIP32_COMPONENTS_IN_PATH),
+            cb
+        );
     } else {
         generate_and_respond_with_compressed_public_key();
     }
@@ -96,7 +99,7 @@ static void generate_publickey_require_confirmation_if_needed(
 // handle_get_public_key is the entry point for the getPublicKey command. It
 // reads the command parameters, prepares and displays the approval screen,
 // and sets the IO_ASYNC_REPLY flag.
-void handle_get_public_key(
+status_word_t handle_get_public_key(
     uint8_t p1, 
     uint8_t p2, 
     uint8_t *data_buffer,
@@ -113,13 +116,14 @@ void handle_get_public_key(
     if (data_length != expected_data_length) {
         PRINTF("'data_length' must be: %u, but was: %d\n", expected_data_length,
                data_length);
-        THROW(SW_INVALID_PARAM);
+        return SW_INVALID_PARAM;
     }
 
     // READ BIP 32 path
-    G_ui_state.length_lower_line_long = parse_bip32_path_from_apdu_command(
-        data_buffer, ctx->bip32_path, G_ui_state.lower_line_long,
-        BIP32_PATH_STRING_MAX_LENGTH);
+    status_word_t sw = parse_bip32_path_from_apdu_command(data_buffer, ctx->bip32_path);
+    if (sw != SW_OK) {
+        return sw;
+    }
 
     *flags |= IO_ASYNCH_REPLY;
 
@@ -129,4 +133,113 @@ void handle_get_public_key(
     }
     generate_publickey_require_confirmation_if_needed(
         (p1 == P1_REQUIRE_CONFIRMATION_BEFORE_GENERATION));
+    return SW_OK;
+}
+
+static get_public_keys_context_t *keys_ctx = &global.get_public_keys_context;
+
+static void generate_and_respond_with_compressed_public_keys() {
+    cx_ecfp_public_key_t public_key;
+    uint32_t start_index = keys_ctx->bip32_path[4];
+    uint16_t tx = 0;
+
+    for (uint8_t i = 0; i < keys_ctx->number_of_keys; ++i) {
+        keys_ctx->bip32_path[4] = start_index + i;
+        if (!derive_radix_key_pair(
+            keys_ctx->bip32_path,
+            &public_key,
+            NULL  // dont write private key
+        )) {
+            PRINTF("Failed to derive public key at offset %d\n", i);
+            io_exchange_with_code(SW_INTERNAL_ERROR_ECC, 0);
+            ui_idle();
+            return;
+        }
+        assert(public_key.W_len == PUBLIC_KEY_COMPRESSEED_BYTE_COUNT);
+
+        os_memmove(
+            G_io_apdu_buffer + tx,
+            public_key.W,
+            PUBLIC_KEY_COMPRESSEED_BYTE_COUNT
+        );
+        tx += PUBLIC_KEY_COMPRESSEED_BYTE_COUNT;
+    }
+
+    io_exchange_with_code(SW_OK, tx);
+    ui_idle();
+}
+
+static void proceed_to_public_keys_generation_confirmation() {
+    char number_of_keys_string[DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE + 1];
+    SPRINTF(number_of_keys_string, "%d keys", keys_ctx->number_of_keys);
+    display_lines("Generate", number_of_keys_string, generate_and_respond_with_compressed_public_keys);
+}
+
+// handle_get_public_keys is the entry point for the getPublicKeys command,
+// used for address-range scans. It reads `account`, `change` and `start index`
+// (same layout as getPublicKey) followed by a single byte `count`, and responds
+// with the compressed public keys at indices `[start index, start index + count)`
+// concatenated. At most `MAX_NUMBER_OF_PUBLIC_KEYS_PER_RESPONSE` keys are
+// returned, the host is expected to ask for the remaining keys in a subsequent
+// request. If confirmation is required, a single approval covers the whole range.
+status_word_t handle_get_public_keys(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *data_buffer,
+    uint16_t data_length,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx
+) {
+    PRINTF("Handle instruction 'GET_PUBLIC_KEYS' from host machine.\n");
+    uint16_t expected_number_of_bip32_compents = 3;
+    uint16_t byte_count_bip_component = 4;
+    uint16_t expected_bip32_byte_count =
+        expected_number_of_bip32_compents * byte_count_bip_component;
+    uint16_t expected_data_length = expected_bip32_byte_count + 1; // +1 for `count`
+
+    if (data_length != expected_data_length) {
+        PRINTF("'data_length' must be: %u, but was: %d\n", expected_data_length,
+               data_length);
+        return SW_INVALID_PARAM;
+    }
+
+    uint8_t number_of_keys = data_buffer[expected_bip32_byte_count];
+    if (number_of_keys == 0) {
+        PRINTF("'count' must be greater than zero\n");
+        return SW_INVALID_PARAM;
+    }
+    if (number_of_keys > MAX_NUMBER_OF_PUBLIC_KEYS_PER_RESPONSE) {
+        number_of_keys = MAX_NUMBER_OF_PUBLIC_KEYS_PER_RESPONSE;
+    }
+
+    // READ BIP 32 path (of the first key)
+    status_word_t sw = parse_bip32_path_from_apdu_command(data_buffer, keys_ctx->bip32_path);
+    if (sw != SW_OK) {
+        return sw;
+    }
+
+    uint32_t start_index = keys_ctx->bip32_path[4];
+    if (start_index > UINT32_MAX - (number_of_keys - 1)) {
+        PRINTF("Address index overflows for 'count': %d\n", number_of_keys);
+        return SW_INVALID_PARAM;
+    }
+    uint32_t last_index = start_index + (number_of_keys - 1);
+    if (start_index < 0x80000000 && last_index >= 0x80000000) {
+        PRINTF("Address indices must not cross into hardened for 'count': %d\n", number_of_keys);
+        return SW_INVALID_PARAM;
+    }
+    keys_ctx->number_of_keys = number_of_keys;
+
+    *flags |= IO_ASYNCH_REPLY;
+
+    if (p1 == P1_REQUIRE_CONFIRMATION_BEFORE_GENERATION) {
+        display_value(
+            "First key at",
+            bip32_path_display_source(keys_ctx->bip32_path, NUMBER_OF_BIP32_COMPONENTS_IN_PATH),
+            proceed_to_public_keys_generation_confirmation
+        );
+    } else {
+        generate_and_respond_with_compressed_public_keys();
+    }
+    return SW_OK;
 }
@@ -0,0 +1,29 @@
+#include "stack_usage.h"
+
+#ifdef HAVE_STACK_USAGE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include "ui.h"
+#include "common_macros.h"
+
+// handle_get_stack_usage is the entry point for the getStackUsage command,
+// only available in builds made with `make STACK_USAGE=1`. It unconditionally
+// sends the lowest number of untouched stack bytes seen per instruction, in
+// the layout documented by `write_stack_usage`.
+status_word_t handle_get_stack_usage(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *data_buffer,
+    uint16_t data_length,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx
+) {
+    PRINTF("Handle instruction 'GET_STACK_USAGE' from host machine.\n");
+    io_exchange_with_code(SW_OK, write_stack_usage(G_io_apdu_buffer));
+    return SW_OK;
+}
+
+#endif // HAVE_STACK_USAGE
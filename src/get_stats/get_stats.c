@@ -0,0 +1,23 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include "ui.h"
+#include "common_macros.h"
+#include "stats.h"
+
+// handle_get_stats is the entry point for the getStats command. It
+// unconditionally sends the performance counters kept since the app was
+// started, in the layout documented by `write_stats`, without changing them.
+status_word_t handle_get_stats(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *data_buffer,
+    uint16_t data_length,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx
+) {
+    PRINTF("Handle instruction 'GET_STATS' from host machine.\n");
+    io_exchange_with_code(SW_OK, write_stats(G_io_apdu_buffer));
+    return SW_OK;
+}
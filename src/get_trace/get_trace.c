@@ -0,0 +1,34 @@
+#include "trace.h"
+
+#ifdef HAVE_TRACE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include "ui.h"
+#include "common_macros.h"
+
+#define P1_CLEAR_AFTER_READING 0x01
+
+// handle_get_trace is the entry point for the getTrace command, only
+// available in builds made with `make TRACE=1`. It unconditionally sends the
+// most recent trace events, in the layout documented by `write_trace`, and
+// forgets them if P1 is `P1_CLEAR_AFTER_READING`.
+status_word_t handle_get_trace(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *data_buffer,
+    uint16_t data_length,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx
+) {
+    uint16_t length = write_trace(G_io_apdu_buffer);
+    if (p1 == P1_CLEAR_AFTER_READING) {
+        trace_clear();
+    }
+    io_exchange_with_code(SW_OK, length);
+    return SW_OK;
+}
+
+#endif // HAVE_TRACE
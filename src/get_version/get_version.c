@@ -8,7 +8,7 @@
 
 // handle_get_version is the entry point for the getVersion command. It
 // unconditionally sends the app version.
-void handle_get_version(
+status_word_t handle_get_version(
     uint8_t p1, 
     uint8_t p2, 
     uint8_t *data_buffer,
@@ -21,4 +21,5 @@ void handle_get_version(
 	G_io_apdu_buffer[1] = APPVERSION[2] - '0';
 	G_io_apdu_buffer[2] = APPVERSION[4] - '0';
 	io_exchange_with_code(SW_OK, 3);
+    return SW_OK;
 }
@@ -8,6 +8,8 @@
 #include "common_macros.h"
 #include "global_state.h"
 #include "key_and_signatures.h"
+#include "stats.h"
+#include "trace.h"
 #include "stringify_bip32_path.h"
 #include "ui.h"
 
@@ -25,25 +27,15 @@ static void display_shared_secret_if_needed() {
         return;
     }
     
-    G_ui_state.length_lower_line_long =
-        hexadecimal_string_from(
-                                G_io_apdu_buffer,
-                                PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT,
-                                G_ui_state.lower_line_long
-                                );
-    
-    display_value("Shared key", key_exchange_done);
+    // The shared key stays in the response until it is sent.
+    display_value(
+        "Shared key",
+        hex_display_source(G_io_apdu_buffer, PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT),
+        key_exchange_done
+    );
 }
 
 static void do_key_change_and_respond_with_point_on_curve() {
-    if (cx_ecfp_is_valid_point(
-                           CX_CURVE_SECP256K1,
-                           ctx->public_key_of_other_party,
-                               PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT) != 1) {
-        PRINTF("Invalid public key, 'point' not on the curve");
-        THROW(SW_INVALID_PARAM);
-    }
-    
     cx_ecfp_private_key_t private_key;
 
     if (!derive_radix_key_pair_should_compress(
@@ -58,11 +50,13 @@ static void do_key_change_and_respond_with_point_on_curve() {
         return;
     }
     
-    int actual_size_of_secret = 0;
-    int error = 0;
+    volatile int actual_size_of_secret = 0;
+    volatile int error = 0;
     BEGIN_TRY {
         TRY {
                 io_seproxyhal_io_heartbeat();
+                stats_count_operation(STATS_OPERATION_ECDH);
+                TRACE(TRACE_EVENT_ECDH_BEGIN, 0, 0);
             actual_size_of_secret = cx_ecdh(
                     &private_key,
                     CX_ECDH_POINT, // or `CX_ECDH_X`
@@ -70,7 +64,7 @@ static void do_key_change_and_respond_with_point_on_curve() {
                     PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT,
                     G_io_apdu_buffer,
                     PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT);
-                    
+                TRACE(TRACE_EVENT_ECDH_END, actual_size_of_secret, 0);
       
         }
         CATCH_OTHER(e) { error = e; }
@@ -84,10 +78,11 @@ static void do_key_change_and_respond_with_point_on_curve() {
     // Ultra important step, MUST zero out the private, else sensitive information is leaked.
     explicit_bzero((cx_ecfp_private_key_t *)&private_key, sizeof(cx_ecfp_private_key_t));
     
-    assert(actual_size_of_secret == PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT);
-    
-    if (error) {
-        print_error_by_code(error);
+    // A failed ECDH is responded to, not thrown out of the UX flow.
+    if (error || actual_size_of_secret != PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT) {
+        if (error) {
+            print_error_by_code(error);
+        }
         PRINTF("Key exchange failed, failed to perform ECDH\n");
         io_exchange_with_code(SW_INTERNAL_ERROR_ECC, 0);
         ui_idle();
@@ -103,19 +98,8 @@ static void proceed_to_exchange_confirmation() {
 }
 
 static void proceed_to_display_other_pubkey() {
-    clear_lower_line_long();
-    
-    
-    G_ui_state.length_lower_line_long =
-        hexadecimal_string_from(
-                                ctx->public_key_of_other_party,
-                                PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT,
-                                G_ui_state.lower_line_long
-                                );
-    
-    PRINTF("G_ui_state.length_lower_line_long: %d\n", G_ui_state.length_lower_line_long);
-    
     display_value("Other pubkey",
+                  hex_display_source(ctx->public_key_of_other_party, PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT),
                   proceed_to_exchange_confirmation);
 }
 
@@ -123,6 +107,7 @@ static void generate_sharedkey_require_confirmation_if_needed(
     bool requireConfirmationDoingDiffieHellman) {
     if (requireConfirmationDoingDiffieHellman) {
         display_value("Your key at:",
+                      bip32_path_display_source(ctx->bip32_path, NUMBER_OF_BIP32_COMPONENTS_IN_PATH),
                       proceed_to_display_other_pubkey);
     } else {
         do_key_change_and_respond_with_point_on_curve();
@@ -132,7 +117,7 @@ static void generate_sharedkey_require_confirmation_if_needed(
 #define P1_REQUIRE_CONFIRMATION_BEFORE_KEY_EXCHANGE 0x01
 #define P2_DISPLAY_SHARED_KEY 0x01
 
-void handle_key_exchange(
+status_word_t handle_key_exchange(
         uint8_t p1,
         uint8_t p2,
         uint8_t *data_buffer,
@@ -155,24 +140,32 @@ void handle_key_exchange(
     if (data_length != expected_data_length) {
         PRINTF("'data_length' must be: %u, but was: %d\n", expected_data_length,
                data_length);
-        THROW(SW_INVALID_PARAM);
+        return SW_INVALID_PARAM;
     }
 
     // READ BIP 32 path
-    G_ui_state.length_lower_line_long =
-    parse_bip32_path_from_apdu_command(
-        data_buffer,
-        ctx->bip32_path,
-        G_ui_state.lower_line_long,
-        BIP32_PATH_STRING_MAX_LENGTH);
+    status_word_t sw = parse_bip32_path_from_apdu_command(data_buffer, ctx->bip32_path);
+    if (sw != SW_OK) {
+        return sw;
+    }
     
     // Copy public key bytes
     os_memmove(ctx->public_key_of_other_party, data_buffer + expected_data_length_path, expected_lenght_public_key_of_other_party);
 
+    // Checked before asking the user to confirm anything.
+    if (cx_ecfp_is_valid_point(
+                           CX_CURVE_SECP256K1,
+                           ctx->public_key_of_other_party,
+                               PUBLIC_KEY_UNCOMPRESSEED_BYTE_COUNT) != 1) {
+        PRINTF("Invalid public key, 'point' not on the curve");
+        return SW_INVALID_PARAM;
+    }
+
     ctx->display_shared_key_on_device = (p2 == P2_DISPLAY_SHARED_KEY);
     
     *flags |= IO_ASYNCH_REPLY;
 
     generate_sharedkey_require_confirmation_if_needed(
         (p1 == P1_REQUIRE_CONFIRMATION_BEFORE_KEY_EXCHANGE));
+    return SW_OK;
 }
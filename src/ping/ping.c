@@ -6,7 +6,42 @@
 #include "ui.h"
 #include "common_macros.h"
 
-void handle_ping(
+// P1 of ping, selecting what to answer with.
+#define P1_PING 0x00
+// Answer with the payload, repeated or cut to P2 bytes.
+#define P1_LOOPBACK_ECHO 0x01
+// Answer with P2 bytes counting up from 0, ignoring the payload.
+#define P1_LOOPBACK_SYNTHESIZE 0x02
+
+// At most 255 bytes are answered, which with the status word fits into
+// G_io_apdu_buffer.
+static void handle_loopback(
+    uint8_t p1,
+    uint8_t response_size,
+    uint8_t *data_buffer,
+    uint16_t data_length
+) {
+    PRINTF("Loopback of %d bytes, answering with %d bytes\n", data_length, response_size);
+    if (p1 == P1_LOOPBACK_SYNTHESIZE || data_length == 0) {
+        for (uint16_t i = 0; i < response_size; ++i) {
+            G_io_apdu_buffer[i] = i & 0xFF;
+        }
+    } else {
+        // The payload starts at `OFFSET_CDATA` of the same buffer, move it
+        // down before repeating it.
+        uint16_t length = data_length < response_size ? data_length : response_size;
+        os_memmove(G_io_apdu_buffer, data_buffer, length);
+        for (uint16_t i = length; i < response_size; ++i) {
+            G_io_apdu_buffer[i] = G_io_apdu_buffer[i - length];
+        }
+    }
+    io_exchange_with_code(SW_OK, response_size);
+}
+
+// handle_ping is the entry point for the ping command. With P1 `P1_PING` it
+// answers "pong" to "ping" and "hello" to anything else. With the loopback
+// P1 values it answers with P2 bytes, for measuring the transport.
+status_word_t handle_ping(
     uint8_t p1, 
     uint8_t p2, 
     uint8_t *data_buffer,
@@ -15,6 +50,17 @@ void handle_ping(
     volatile unsigned int *tx
 ) {
     PRINTF("Handle instruction 'PING' from host machine. ");
+    switch (p1) {
+        case P1_PING:
+            break;
+        case P1_LOOPBACK_ECHO:
+        case P1_LOOPBACK_SYNTHESIZE:
+            handle_loopback(p1, p2, data_buffer, data_length);
+            return SW_OK;
+        default:
+            PRINTF("Invalid P1 for ping: %d\n", p1);
+            return SW_INVALID_PARAM;
+    }
     int pingLength = 4;
     uint8_t expected[pingLength+1];
     expected[0] = 'p';
@@ -35,4 +81,5 @@ void handle_ping(
         PRINTF("Answering with 'pong'\n");
         io_exchange_with_code(SW_OK, pongLength);
 	}
+    return SW_OK;
 }
@@ -13,7 +13,7 @@ static sign_hash_context_t *ctx = &global.sign_hash_context;
 
 static void did_finish_sign_hash_flow() {
     size_t tx = derive_sign_move_to_global_buffer(ctx->bip32_path, ctx->hash);
-    io_exchange_with_code(SW_OK, tx);
+    io_exchange_with_code(tx > 0 ? SW_OK : SW_INTERNAL_ERROR_ECC, tx);
     ui_idle();
 }
 
@@ -22,17 +22,10 @@ static void proceed_to_final_signature_confirmation() {
 }
 
 static void ask_user_to_confirm_hash() {
-    G_ui_state.length_lower_line_long =
-        hexadecimal_string_from(
-                                ctx->hash,
-                                HASH256_BYTE_COUNT,
-                                G_ui_state.lower_line_long
-                                );
-    
-    display_value("Verify Hash", proceed_to_final_signature_confirmation);
+    display_value("Verify Hash", hex_display_source(ctx->hash, HASH256_BYTE_COUNT), proceed_to_final_signature_confirmation);
 }
 
-void handle_sign_hash(
+status_word_t handle_sign_hash(
     uint8_t p1,
     uint8_t p2,
     uint8_t *data_buffer,
@@ -50,18 +43,19 @@ void handle_sign_hash(
     if (data_length != expected_data_length) {
         PRINTF("'data_length' must be: %u, but was: %d\n", expected_data_length,
                data_length);
-        THROW(SW_INVALID_PARAM);
+        return SW_INVALID_PARAM;
     }
 
     // Parse BIP 32
     size_t offset_of_data = 0;
     
-    parse_bip32_path_from_apdu_command(
+    status_word_t sw = parse_bip32_path_from_apdu_command(
         data_buffer + offset_of_data,
-        ctx->bip32_path,
-        NULL, 
-        0
+        ctx->bip32_path
     );
+    if (sw != SW_OK) {
+        return sw;
+    }
 
     offset_of_data += expected_bip32_byte_count;
 
@@ -71,4 +65,5 @@ void handle_sign_hash(
     ask_user_to_confirm_hash();
 
     *flags |= IO_ASYNCH_REPLY;
+    return SW_OK;
 }
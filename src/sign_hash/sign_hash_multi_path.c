@@ -0,0 +1,127 @@
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include <cx.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common_macros.h"
+#include "global_state.h"
+#include "key_and_signatures.h"
+#include "ui.h"
+#include "base_conversion.h"
+
+static sign_hash_multi_path_context_t *ctx = &global.sign_hash_multi_path_context;
+
+// Signs the hash with the key at each path, writing the signatures into
+// G_io_apdu_buffer.
+static status_word_t sign_hash_with_key_at_each_path(uint16_t *output_length) {
+    volatile cx_ecfp_private_key_t private_key;
+    uint16_t tx = 0;
+
+    for (uint8_t i = 0; i < ctx->number_of_paths; ++i) {
+        if (!derive_radix_key_pair_should_compress(
+            ctx->bip32_paths[i],
+            NULL,  // dont write public key
+            &private_key,
+            false
+        )) {
+            PRINTF("Failed to derive private key for path at index %d.\n", i);
+            return SW_INTERNAL_ERROR_ECC;
+        }
+
+        size_t signature_length = sign_hash_move_to_buffer(
+            (cx_ecfp_private_key_t *)&private_key,
+            ctx->hash,
+            G_io_apdu_buffer + tx
+        );
+
+        // Ultra important step, MUST zero out the private, else sensitive information is leaked.
+        explicit_bzero((cx_ecfp_private_key_t *)&private_key, sizeof(cx_ecfp_private_key_t));
+
+        if (signature_length != ECSDA_SIGNATURE_BYTE_COUNT) {
+            return SW_INTERNAL_ERROR_ECC;
+        }
+        tx += signature_length;
+    }
+
+    *output_length = tx;
+    return SW_OK;
+}
+
+static void did_finish_sign_hash_multi_path_flow() {
+    uint16_t tx = 0;
+    status_word_t sw = sign_hash_with_key_at_each_path(&tx);
+    io_exchange_with_code(sw, sw == SW_OK ? tx : 0);
+    ui_idle();
+}
+
+static void proceed_to_final_signatures_confirmation() {
+    char number_of_keys_string[DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE + 1];
+    SPRINTF(number_of_keys_string, "with %d keys", ctx->number_of_paths);
+    display_lines("Sign content", number_of_keys_string, did_finish_sign_hash_multi_path_flow);
+}
+
+static void ask_user_to_confirm_hash() {
+    display_value("Verify Hash", hex_display_source(ctx->hash, HASH256_BYTE_COUNT), proceed_to_final_signatures_confirmation);
+}
+
+// handle_sign_hash_multi_path is the entry point for the signHashMultiPath
+// command, signing one hash with the keys at several BIP32 paths after a
+// single review. Reads the hash (32 bytes), the number of paths (1 byte) and
+// then the paths (12 bytes each, same layout as signHash). Responds with the
+// signatures (64 bytes each) in the same order as the paths.
+status_word_t handle_sign_hash_multi_path(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *data_buffer,
+    uint16_t data_length,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx
+) {
+    PRINTF("Handle instruction 'SIGN_HASH_MULTI_PATH' from host machine.\n");
+    uint16_t expected_number_of_bip32_compents = 3;
+    uint16_t byte_count_bip_component = 4;
+    uint16_t expected_bip32_byte_count =
+        expected_number_of_bip32_compents * byte_count_bip_component;
+
+    uint16_t header_length = HASH256_BYTE_COUNT + 1; // +1 for number of paths
+    if (data_length < header_length) {
+        PRINTF("'data_length' must be at least: %u, but was: %d\n", header_length, data_length);
+        return SW_INVALID_PARAM;
+    }
+
+    uint8_t number_of_paths = data_buffer[HASH256_BYTE_COUNT];
+    if (number_of_paths == 0 || number_of_paths > MAX_NUMBER_OF_SIGNATURES_PER_RESPONSE) {
+        PRINTF("Number of paths must be in [1, %d], but was: %d\n", MAX_NUMBER_OF_SIGNATURES_PER_RESPONSE, number_of_paths);
+        return SW_INVALID_PARAM;
+    }
+
+    uint16_t expected_data_length = header_length + number_of_paths * expected_bip32_byte_count;
+    if (data_length != expected_data_length) {
+        PRINTF("'data_length' must be: %u, but was: %d\n", expected_data_length,
+               data_length);
+        return SW_INVALID_PARAM;
+    }
+
+    // Read the hash.
+    os_memmove(ctx->hash, data_buffer, HASH256_BYTE_COUNT);
+
+    // Parse BIP 32 paths
+    size_t offset_of_data = header_length;
+    for (uint8_t i = 0; i < number_of_paths; ++i) {
+        status_word_t sw = parse_bip32_path_from_apdu_command(
+            data_buffer + offset_of_data,
+            ctx->bip32_paths[i]
+        );
+        if (sw != SW_OK) {
+            return sw;
+        }
+        offset_of_data += expected_bip32_byte_count;
+    }
+    ctx->number_of_paths = number_of_paths;
+
+    ask_user_to_confirm_hash();
+
+    *flags |= IO_ASYNCH_REPLY;
+    return SW_OK;
+}
@@ -0,0 +1,160 @@
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include <cx.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common_macros.h"
+#include "global_state.h"
+#include "key_and_signatures.h"
+#include "ui.h"
+#include "base_conversion.h"
+#include "input_chain.h"
+
+static sign_hashes_context_t *ctx = &global.sign_hashes_context;
+
+static status_word_t sign_all_hashes() {
+    volatile cx_ecfp_private_key_t private_key;
+    uint8_t hash[HASH256_BYTE_COUNT];
+
+    // Derive the private key once, used for all signatures.
+    if (!derive_radix_key_pair_should_compress(
+        ctx->bip32_path,
+        NULL,  // dont write public key
+        &private_key,
+        false
+    )) {
+        PRINTF("Failed to derive private key.\n");
+        return SW_INTERNAL_ERROR_ECC;
+    }
+
+    // A signature is twice as long as a hash, by signing the hashes
+    // backwards the signature at index `i` only ever overwrites hashes at
+    // index `>= i` i.e. hashes already signed (hash `i` itself is copied out
+    // before signing).
+    status_word_t sw = SW_OK;
+    for (int i = ctx->number_of_hashes - 1; i >= 0 && sw == SW_OK; --i) {
+        os_memcpy(hash, ctx->hashes_then_signatures + i * HASH256_BYTE_COUNT, HASH256_BYTE_COUNT);
+        if (sign_hash_move_to_buffer(
+            (cx_ecfp_private_key_t *)&private_key,
+            hash,
+            ctx->hashes_then_signatures + i * ECSDA_SIGNATURE_BYTE_COUNT
+        ) != ECSDA_SIGNATURE_BYTE_COUNT) {
+            sw = SW_INTERNAL_ERROR_ECC;
+        }
+    }
+
+    // Ultra important step, MUST zero out the private, else sensitive information is leaked.
+    explicit_bzero((cx_ecfp_private_key_t *)&private_key, sizeof(cx_ecfp_private_key_t));
+    return sw;
+}
+
+static void did_finish_sign_hashes_flow() {
+    status_word_t sw = sign_all_hashes();
+    if (sw != SW_OK) {
+        io_exchange_with_code(sw, 0);
+        ui_idle();
+        return;
+    }
+    io_exchange_with_chained_data(
+        ctx->hashes_then_signatures,
+        ctx->number_of_hashes * ECSDA_SIGNATURE_BYTE_COUNT
+    );
+    ui_idle();
+}
+
+static void proceed_to_final_signatures_confirmation() {
+    display_lines("Sign hashes", "Confirm?", did_finish_sign_hashes_flow);
+}
+
+static void ask_user_to_confirm_digest_of_hashes() {
+    cx_hash_sha256(
+        ctx->hashes_then_signatures, ctx->number_of_hashes * HASH256_BYTE_COUNT,
+        ctx->digest_of_hashes, HASH256_BYTE_COUNT
+    );
+
+    char title[DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE + 1];
+    SPRINTF(title, "%d hashes", ctx->number_of_hashes);
+    display_value(
+        title,
+        hex_display_source(ctx->digest_of_hashes, HASH256_BYTE_COUNT),
+        proceed_to_final_signatures_confirmation
+    );
+}
+
+// Reads the hashes of the input, a hash may be split across APDUs.
+static status_word_t read_hashes() {
+    while (!input_chain_is_fully_read()) {
+        if (ctx->number_of_hashes == MAX_NUMBER_OF_HASHES_TO_SIGN) {
+            PRINTF("More than %d hashes.\n", MAX_NUMBER_OF_HASHES_TO_SIGN);
+            return SW_INVALID_PARAM;
+        }
+        if (!input_chain_read(
+            ctx->hashes_then_signatures + ctx->number_of_hashes * HASH256_BYTE_COUNT,
+            HASH256_BYTE_COUNT
+        )) {
+            break;
+        }
+        ctx->number_of_hashes++;
+    }
+    return SW_OK;
+}
+
+// handle_sign_hashes is the entry point for the signHashes command, signing
+// up to `MAX_NUMBER_OF_HASHES_TO_SIGN` hashes with the key at one BIP32 path,
+// after a single review of the number of hashes and a digest (SHA256) of all
+// of them.
+//
+// The input is chained over APDUs (see `input_chain.h`): the BIP32 path (12
+// bytes, within the first APDU) followed by the hashes, which may be split
+// across APDUs at any byte.
+//
+// Once the last APDU has been received, the user is asked to review and the
+// private key is derived once to sign all hashes. The response contains all
+// signatures, chained over several APDUs, see `io_exchange_with_chained_data`.
+status_word_t handle_sign_hashes(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t *data_buffer,
+    uint16_t data_length,
+    volatile unsigned int *flags,
+    volatile unsigned int *tx
+) {
+    PRINTF("Handle instruction 'SIGN_HASHES' from host machine.\n");
+    uint16_t expected_bip32_byte_count = BIP32_PATH_LEN;
+
+    if (input_chain_is_first_chunk()) {
+        explicit_bzero(ctx, sizeof(sign_hashes_context_t));
+
+        uint8_t bip32_path_bytes[BIP32_PATH_LEN];
+        if (!input_chain_read(bip32_path_bytes, expected_bip32_byte_count)) {
+            PRINTF("'data_length' must be at least: %u, but was: %d\n", expected_bip32_byte_count, data_length);
+            return SW_INVALID_PARAM;
+        }
+        status_word_t sw = parse_bip32_path_from_apdu_command(bip32_path_bytes, ctx->bip32_path);
+        if (sw != SW_OK) {
+            return sw;
+        }
+    }
+
+    status_word_t sw = read_hashes();
+    if (sw != SW_OK) {
+        return sw;
+    }
+
+    if (!input_chain_is_last_chunk()) {
+        // Waiting for more hashes.
+        io_exchange_with_code(SW_OK, 0);
+        return SW_OK;
+    }
+
+    if (!input_chain_is_fully_read() || ctx->number_of_hashes == 0) {
+        PRINTF("Input must be a whole number of hashes, at least one.\n");
+        return SW_INVALID_PARAM;
+    }
+
+    ask_user_to_confirm_digest_of_hashes();
+
+    *flags |= IO_ASYNCH_REPLY;
+    return SW_OK;
+}
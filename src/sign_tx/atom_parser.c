@@ -0,0 +1,321 @@
+#include "atom_parser.h"
+#include <stddef.h>
+#include <string.h>
+#include <os.h>
+
+#define FIELD_NONE 0
+#define FIELD_PARTICLE 1
+#define FIELD_SPIN 2
+#define FIELD_SERIALIZER 3
+#define FIELD_ADDRESS 4
+#define FIELD_AMOUNT 5
+#define FIELD_TOKEN_DEFINITION_REFERENCE 6
+
+#define KEY_LENGTH_TOO_LONG 0xFF
+
+static const char serializer_transferrable_tokens[] = "radix.particles.transferrable_tokens";
+
+typedef struct {
+    atom_parser_t *parser;
+    did_parse_transfer_callback_t did_parse_transfer;
+} feed_context_t;
+
+static bool is_key(atom_parser_t *parser, const char *key) {
+    size_t length = strlen(key);
+    return parser->key_length == length && os_memcmp(parser->key, key, length) == 0;
+}
+
+static uint8_t field_of_key(atom_parser_t *parser, uint8_t depth) {
+    if (parser->key_length == KEY_LENGTH_TOO_LONG) {
+        return FIELD_NONE;
+    }
+
+    if (parser->is_inside_particle) {
+        if (depth != parser->particle_depth + 1) {
+            return FIELD_NONE;
+        }
+        if (is_key(parser, "address")) {
+            return FIELD_ADDRESS;
+        }
+        if (is_key(parser, "amount")) {
+            return FIELD_AMOUNT;
+        }
+        if (is_key(parser, "tokenDefinitionReference")) {
+            return FIELD_TOKEN_DEFINITION_REFERENCE;
+        }
+        if (is_key(parser, "serializer")) {
+            return FIELD_SERIALIZER;
+        }
+        return FIELD_NONE;
+    }
+
+    // Keys of the "spun particle" map, which holds both the particle and its spin.
+    if (is_key(parser, "spin")) {
+        return FIELD_SPIN;
+    }
+    if (is_key(parser, "particle")) {
+        return FIELD_PARTICLE;
+    }
+    return FIELD_NONE;
+}
+
+static void did_read_key_fragment(atom_parser_t *parser, const cbor_token_t *token) {
+    if (token->fragment_offset == 0) {
+        parser->key_length = 0;
+    }
+    if (token->major_type != CBOR_MAJOR_TYPE_TEXT_STRING || token->argument > ATOM_PARSER_MAX_KEY_LENGTH) {
+        parser->key_length = KEY_LENGTH_TOO_LONG;
+    } else if (parser->key_length != KEY_LENGTH_TOO_LONG) {
+        os_memcpy(parser->key + parser->key_length, token->fragment, token->fragment_length);
+        parser->key_length += token->fragment_length;
+    }
+
+    if (token->is_last_fragment) {
+        parser->key_depth = token->depth;
+        parser->field = field_of_key(parser, token->depth);
+    }
+}
+
+// Copies the fragment of a DSON byte string prefixed with `prefix` into
+// `destination`, which is `byte_count` bytes, straight away, even if the
+// string is split across several chunks. Strings longer than `byte_count`
+// (plus prefix) are malformed, unless `allow_shorter`.
+static bool copy_dson_bytes_fragment(
+    const cbor_token_t *token,
+    uint8_t prefix,
+    uint8_t *destination,
+    uint16_t byte_count,
+    bool allow_shorter
+) {
+    uint32_t expected_length = DSON_PREFIX_BYTE_COUNT + byte_count;
+    if (token->major_type != CBOR_MAJOR_TYPE_BYTE_STRING ||
+        token->argument > expected_length ||
+        token->argument <= DSON_PREFIX_BYTE_COUNT ||
+        (!allow_shorter && token->argument != expected_length)) {
+        return false;
+    }
+
+    const uint8_t *fragment = token->fragment;
+    uint16_t fragment_length = token->fragment_length;
+    uint32_t offset = token->fragment_offset;
+
+    if (offset == 0 && fragment_length > 0) {
+        if (fragment[0] != prefix) {
+            return false;
+        }
+        fragment++;
+        fragment_length--;
+    } else {
+        offset -= DSON_PREFIX_BYTE_COUNT;
+    }
+
+    os_memcpy(destination + offset, fragment, fragment_length);
+    return true;
+}
+
+static void did_read_field_fragment(atom_parser_t *parser, const cbor_token_t *token) {
+    transfer_t *transfer = &parser->transfer;
+    bool is_valid = true;
+
+    switch (parser->field) {
+        case FIELD_ADDRESS: {
+            is_valid = copy_dson_bytes_fragment(
+                token, DSON_PREFIX_ADDRESS,
+                transfer->address.bytes, RADIX_ADDRESS_BYTE_COUNT,
+                false
+            );
+            transfer->is_address_set = is_valid && token->is_last_fragment;
+            break;
+        }
+        case FIELD_AMOUNT: {
+            is_valid = copy_dson_bytes_fragment(
+                token, DSON_PREFIX_UINT256,
+                transfer->amount.bytes, RADIX_AMOUNT_BYTE_COUNT,
+                false
+            );
+            transfer->is_amount_set = is_valid && token->is_last_fragment;
+            break;
+        }
+        case FIELD_TOKEN_DEFINITION_REFERENCE: {
+            // Only tokens of transfers are interned, other particles would
+            // use up the table. DSON sorts the keys, so "serializer" has
+            // been read by now.
+            if (!parser->is_serializer_transferrable_tokens) {
+                break;
+            }
+            // Assembled in the RRI table, then interned, the transfer only
+            // holds its index.
+            is_valid = copy_dson_bytes_fragment(
+                token, DSON_PREFIX_RRI,
+                rri_table_assembly_buffer(&parser->rri_table), RADIX_RRI_MAX_BYTE_COUNT,
+                true
+            );
+            if (is_valid && token->is_last_fragment) {
+                parser->status = intern_assembled_rri(
+                    &parser->rri_table,
+                    token->argument - DSON_PREFIX_BYTE_COUNT,
+                    &transfer->token_definition_reference_index
+                );
+                transfer->is_token_definition_reference_set = parser->status == SW_OK;
+            }
+            break;
+        }
+        case FIELD_SERIALIZER: {
+            size_t expected_length = sizeof(serializer_transferrable_tokens) - 1;
+            if (token->fragment_offset == 0) {
+                parser->is_serializer_transferrable_tokens =
+                    token->major_type == CBOR_MAJOR_TYPE_TEXT_STRING && token->argument == expected_length;
+            }
+            parser->is_serializer_transferrable_tokens = parser->is_serializer_transferrable_tokens &&
+                os_memcmp(
+                    token->fragment,
+                    serializer_transferrable_tokens + token->fragment_offset,
+                    token->fragment_length
+                ) == 0;
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (!is_valid) {
+        PRINTF("Malformed value of field: %d\n", parser->field);
+        parser->status = SW_INVALID_PARAM;
+    }
+}
+
+static void did_start_particle(atom_parser_t *parser, uint8_t depth) {
+    bool is_mainnet = parser->transfer.address.is_mainnet;
+    explicit_bzero(&parser->transfer, sizeof(transfer_t));
+    parser->transfer.address.is_mainnet = is_mainnet;
+
+    parser->particle_depth = depth;
+    parser->is_inside_particle = true;
+    parser->is_serializer_transferrable_tokens = false;
+    parser->has_pending_transfer = false;
+}
+
+static void did_end_particle(atom_parser_t *parser) {
+    parser->is_inside_particle = false;
+    if (!parser->is_serializer_transferrable_tokens) {
+        return;
+    }
+
+    transfer_t *transfer = &parser->transfer;
+    if (!transfer->is_address_set || !transfer->is_amount_set || !transfer->is_token_definition_reference_set) {
+        PRINTF("Transferrable tokens particle lacks fields.\n");
+        parser->status = SW_INVALID_PARAM;
+        return;
+    }
+    transfer->has_confirmed_serializer = true;
+    parser->has_pending_transfer = true;
+}
+
+// End of the "spun particle" map, holding both the particle and its spin,
+// in either order.
+static void did_end_spun_particle(atom_parser_t *parser, did_parse_transfer_callback_t did_parse_transfer) {
+    bool is_spin_up = parser->is_spin_up && parser->spin_depth == parser->particle_depth;
+    if (parser->has_pending_transfer && is_spin_up) {
+        parser->status = did_parse_transfer(&parser->transfer);
+    }
+    parser->has_pending_transfer = false;
+    parser->particle_depth = ATOM_PARSER_NO_DEPTH;
+}
+
+static void did_read_token(const cbor_token_t *token, void *context) {
+    feed_context_t *feed_context = (feed_context_t *) context;
+    atom_parser_t *parser = feed_context->parser;
+
+    // The tokenizer has no way to stop early, ignore the rest of the chunk.
+    if (parser->status != SW_OK) {
+        return;
+    }
+
+    if (token->is_map_key) {
+        if (token->kind == CBOR_TOKEN_STRING_FRAGMENT) {
+            did_read_key_fragment(parser, token);
+        } else {
+            parser->key_length = KEY_LENGTH_TOO_LONG;
+            parser->field = FIELD_NONE;
+        }
+        return;
+    }
+
+    if (token->kind == CBOR_TOKEN_CONTAINER_END) {
+        if (token->major_type != CBOR_MAJOR_TYPE_MAP) {
+            return;
+        }
+        if (parser->is_inside_particle && token->depth == parser->particle_depth) {
+            did_end_particle(parser);
+        } else if (!parser->is_inside_particle && token->depth + 1 == parser->particle_depth) {
+            did_end_spun_particle(parser, feed_context->did_parse_transfer);
+        }
+        if (token->depth + 1 == parser->spin_depth) {
+            parser->spin_depth = ATOM_PARSER_NO_DEPTH;
+        }
+        return;
+    }
+
+    // Only values directly following a key we look for are of interest,
+    // anything nested inside other values is skipped.
+    if (parser->field == FIELD_NONE || token->depth != parser->key_depth) {
+        return;
+    }
+
+    switch (token->kind) {
+        case CBOR_TOKEN_CONTAINER_START: {
+            if (parser->field == FIELD_PARTICLE && token->major_type == CBOR_MAJOR_TYPE_MAP && !parser->is_inside_particle) {
+                did_start_particle(parser, token->depth);
+            }
+            parser->field = FIELD_NONE;
+            break;
+        }
+        case CBOR_TOKEN_SCALAR: {
+            if (parser->field == FIELD_SPIN) {
+                parser->spin_depth = token->depth;
+                parser->is_spin_up = token->major_type == CBOR_MAJOR_TYPE_UNSIGNED_INTEGER && token->argument == 1;
+            }
+            parser->field = FIELD_NONE;
+            break;
+        }
+        case CBOR_TOKEN_STRING_FRAGMENT: {
+            did_read_field_fragment(parser, token);
+            if (token->is_last_fragment) {
+                parser->field = FIELD_NONE;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void atom_parser_init(atom_parser_t *parser, bool is_mainnet) {
+    explicit_bzero(parser, sizeof(atom_parser_t));
+    cbor_tokenizer_init(&parser->tokenizer);
+    parser->particle_depth = ATOM_PARSER_NO_DEPTH;
+    parser->spin_depth = ATOM_PARSER_NO_DEPTH;
+    parser->status = SW_OK;
+    parser->transfer.address.is_mainnet = is_mainnet;
+}
+
+status_word_t atom_parser_feed(
+    atom_parser_t *parser,
+    const uint8_t *bytes,
+    uint16_t byte_count,
+    did_parse_transfer_callback_t did_parse_transfer
+) {
+    feed_context_t context = {
+        .parser = parser,
+        .did_parse_transfer = did_parse_transfer,
+    };
+    if (!cbor_tokenizer_feed(&parser->tokenizer, bytes, byte_count, did_read_token, &context) && parser->status == SW_OK) {
+        PRINTF("Atom is not well-formed CBOR.\n");
+        parser->status = SW_INVALID_PARAM;
+    }
+    return parser->status;
+}
+
+bool atom_parser_is_done(atom_parser_t *parser) {
+    return cbor_tokenizer_is_done(&parser->tokenizer);
+}
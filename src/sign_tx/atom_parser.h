@@ -0,0 +1,65 @@
+#ifndef ATOMPARSER_H
+#define ATOMPARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cbor_tokenizer.h"
+#include "transfer.h"
+#include "rri_table.h"
+#include "common_macros.h"
+
+// Longest map key we need to recognize: "tokenDefinitionReference".
+#define ATOM_PARSER_MAX_KEY_LENGTH 24
+
+#define ATOM_PARSER_NO_DEPTH 0xFF
+
+// DSON prefixes of byte strings holding Radix specific types.
+#define DSON_PREFIX_ADDRESS 0x04
+#define DSON_PREFIX_UINT256 0x05
+#define DSON_PREFIX_RRI 0x06
+#define DSON_PREFIX_BYTE_COUNT 1
+
+// Returns `SW_OK` to carry on parsing, otherwise the status the atom is
+// rejected with.
+typedef status_word_t (*did_parse_transfer_callback_t)(transfer_t *transfer);
+
+// Streaming parser of a DSON encoded atom, extracting the transfers (address,
+// amount and token of transferrable tokens particles with spin up) while
+// skipping over everything else without copying it.
+typedef struct {
+    cbor_tokenizer_t tokenizer;
+
+    char key[ATOM_PARSER_MAX_KEY_LENGTH];
+    uint8_t key_length;
+    uint8_t key_depth;  // depth of the key the current value belongs to
+    uint8_t field;      // field of the current value
+
+    uint8_t particle_depth;  // depth of the particle map, `ATOM_PARSER_NO_DEPTH` if none
+    bool is_inside_particle;
+    bool is_serializer_transferrable_tokens;
+    uint8_t spin_depth;  // depth of the "spin" key read, `ATOM_PARSER_NO_DEPTH` if none
+    bool is_spin_up;
+    bool has_pending_transfer;
+    status_word_t status;  // `SW_OK` until the atom is rejected
+
+    transfer_t transfer;
+    // Distinct tokens of the transfers parsed so far.
+    rri_table_t rri_table;
+} atom_parser_t;
+
+void atom_parser_init(atom_parser_t *parser, bool is_mainnet);
+
+// Feeds the next bytes of the atom, calling `did_parse_transfer` for every
+// transfer found. Returns `SW_INVALID_PARAM` if the atom is malformed, or the
+// status of the first failing `did_parse_transfer`.
+status_word_t atom_parser_feed(
+    atom_parser_t *parser,
+    const uint8_t *bytes,
+    uint16_t byte_count,
+    did_parse_transfer_callback_t did_parse_transfer
+);
+
+// Returns true once the whole atom has been parsed.
+bool atom_parser_is_done(atom_parser_t *parser);
+
+#endif
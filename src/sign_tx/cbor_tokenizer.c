@@ -0,0 +1,272 @@
+#include "cbor_tokenizer.h"
+#include <stddef.h>
+#include <os.h>
+
+#define PHASE_INITIAL_BYTE 0
+#define PHASE_ARGUMENT 1
+#define PHASE_STRING 2
+
+#define LEVEL_FLAG_IS_MAP 0x01
+#define LEVEL_FLAG_IS_INDEFINITE_LENGTH 0x02
+#define LEVEL_FLAG_EXPECTS_KEY 0x04
+
+#define ADDITIONAL_INFO_MAX_INLINE_ARGUMENT 23
+#define ADDITIONAL_INFO_ONE_BYTE_ARGUMENT 24
+#define ADDITIONAL_INFO_INDEFINITE_LENGTH 31
+
+static cbor_tokenizer_level_t *current_level(cbor_tokenizer_t *tokenizer) {
+    return tokenizer->depth > 0 ? &tokenizer->levels[tokenizer->depth - 1] : NULL;
+}
+
+static bool is_map_key(cbor_tokenizer_t *tokenizer) {
+    cbor_tokenizer_level_t *level = current_level(tokenizer);
+    return level && (level->flags & LEVEL_FLAG_EXPECTS_KEY);
+}
+
+static void init_token(cbor_tokenizer_t *tokenizer, cbor_token_t *token, cbor_token_kind_t kind) {
+    os_memset(token, 0, sizeof(cbor_token_t));
+    token->kind = kind;
+    token->major_type = tokenizer->major_type;
+    token->depth = tokenizer->depth;
+    token->is_map_key = is_map_key(tokenizer);
+}
+
+static uint64_t argument(cbor_tokenizer_t *tokenizer) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < tokenizer->argument_byte_count; ++i) {
+        value = (value << 8) | tokenizer->argument_bytes[i];
+    }
+    return value;
+}
+
+// Pops the container at the current level, emitting its end token.
+static void pop_container(
+    cbor_tokenizer_t *tokenizer,
+    cbor_token_callback_t callback,
+    void *context
+) {
+    cbor_tokenizer_level_t *level = current_level(tokenizer);
+
+    tokenizer->depth--;
+
+    cbor_token_t token;
+    init_token(tokenizer, &token, CBOR_TOKEN_CONTAINER_END);
+    token.major_type = (level->flags & LEVEL_FLAG_IS_MAP) ? CBOR_MAJOR_TYPE_MAP : CBOR_MAJOR_TYPE_ARRAY;
+    token.is_indefinite_length = (level->flags & LEVEL_FLAG_IS_INDEFINITE_LENGTH) != 0;
+    callback(&token, context);
+}
+
+// Called when an item has been completely parsed, updating the enclosing
+// containers, completing those which have received all their items (done
+// iteratively, keeping stack usage independent of the nesting depth).
+static void did_complete_item(
+    cbor_tokenizer_t *tokenizer,
+    cbor_token_callback_t callback,
+    void *context
+) {
+    for (;;) {
+        cbor_tokenizer_level_t *level = current_level(tokenizer);
+        if (!level) {
+            tokenizer->is_done = true;
+            return;
+        }
+
+        if (level->flags & LEVEL_FLAG_IS_MAP) {
+            level->flags ^= LEVEL_FLAG_EXPECTS_KEY;
+        }
+
+        if (level->flags & LEVEL_FLAG_IS_INDEFINITE_LENGTH) {
+            return;
+        }
+
+        level->remaining_items--;
+        if (level->remaining_items > 0) {
+            return;
+        }
+        pop_container(tokenizer, callback, context);
+    }
+}
+
+// Called once the header (initial byte and argument) of an item has been
+// read. Returns false if the item is malformed.
+static bool did_read_header(
+    cbor_tokenizer_t *tokenizer,
+    bool is_indefinite_length,
+    cbor_token_callback_t callback,
+    void *context
+) {
+    cbor_token_t token;
+    tokenizer->phase = PHASE_INITIAL_BYTE;
+
+    switch (tokenizer->major_type) {
+        case CBOR_MAJOR_TYPE_UNSIGNED_INTEGER:
+        case CBOR_MAJOR_TYPE_NEGATIVE_INTEGER:
+        case CBOR_MAJOR_TYPE_SIMPLE_OR_FLOAT: {
+            if (is_indefinite_length) {
+                if (tokenizer->major_type != CBOR_MAJOR_TYPE_SIMPLE_OR_FLOAT) {
+                    return false;
+                }
+                // "break", ending an indefinite length container.
+                cbor_tokenizer_level_t *level = current_level(tokenizer);
+                if (!level || !(level->flags & LEVEL_FLAG_IS_INDEFINITE_LENGTH)) {
+                    return false;
+                }
+                if ((level->flags & LEVEL_FLAG_IS_MAP) && !(level->flags & LEVEL_FLAG_EXPECTS_KEY)) {
+                    return false; // key without value
+                }
+                pop_container(tokenizer, callback, context);
+                did_complete_item(tokenizer, callback, context);
+                return true;
+            }
+            init_token(tokenizer, &token, CBOR_TOKEN_SCALAR);
+            token.argument = argument(tokenizer);
+            callback(&token, context);
+            did_complete_item(tokenizer, callback, context);
+            return true;
+        }
+        case CBOR_MAJOR_TYPE_BYTE_STRING:
+        case CBOR_MAJOR_TYPE_TEXT_STRING: {
+            // Indefinite length (chunked) strings are not used by DSON.
+            uint64_t length = argument(tokenizer);
+            if (is_indefinite_length || length > UINT32_MAX) {
+                return false;
+            }
+            tokenizer->string_length = (uint32_t) length;
+            tokenizer->string_bytes_received = 0;
+            if (length > 0) {
+                tokenizer->phase = PHASE_STRING;
+                return true;
+            }
+            init_token(tokenizer, &token, CBOR_TOKEN_STRING_FRAGMENT);
+            token.is_last_fragment = true;
+            callback(&token, context);
+            did_complete_item(tokenizer, callback, context);
+            return true;
+        }
+        case CBOR_MAJOR_TYPE_ARRAY:
+        case CBOR_MAJOR_TYPE_MAP: {
+            bool is_map = tokenizer->major_type == CBOR_MAJOR_TYPE_MAP;
+            uint64_t number_of_items = is_indefinite_length ? 0 : argument(tokenizer);
+            // Checked before doubling the pairs of a map, which could wrap.
+            if (number_of_items > (is_map ? UINT16_MAX / 2 : UINT16_MAX) ||
+                tokenizer->depth >= CBOR_TOKENIZER_MAX_DEPTH) {
+                return false;
+            }
+            if (is_map) {
+                number_of_items *= 2;
+            }
+
+            init_token(tokenizer, &token, CBOR_TOKEN_CONTAINER_START);
+            token.is_indefinite_length = is_indefinite_length;
+            token.argument = is_indefinite_length ? 0 : argument(tokenizer);
+            callback(&token, context);
+
+            cbor_tokenizer_level_t *level = &tokenizer->levels[tokenizer->depth++];
+            level->remaining_items = (uint16_t) number_of_items;
+            level->flags = 0;
+            if (is_map) {
+                level->flags |= LEVEL_FLAG_IS_MAP | LEVEL_FLAG_EXPECTS_KEY;
+            }
+            if (is_indefinite_length) {
+                level->flags |= LEVEL_FLAG_IS_INDEFINITE_LENGTH;
+            } else if (number_of_items == 0) {
+                pop_container(tokenizer, callback, context);
+                did_complete_item(tokenizer, callback, context);
+            }
+            return true;
+        }
+        case CBOR_MAJOR_TYPE_TAG: {
+            // Tags only annotate the following item, which is emitted as is.
+            return !is_indefinite_length;
+        }
+        default:
+            return false;
+    }
+}
+
+void cbor_tokenizer_init(cbor_tokenizer_t *tokenizer) {
+    os_memset(tokenizer, 0, sizeof(cbor_tokenizer_t));
+}
+
+bool cbor_tokenizer_is_done(cbor_tokenizer_t *tokenizer) {
+    return tokenizer->is_done;
+}
+
+bool cbor_tokenizer_feed(
+    cbor_tokenizer_t *tokenizer,
+    const uint8_t *bytes,
+    uint16_t byte_count,
+    cbor_token_callback_t callback,
+    void *context
+) {
+    uint16_t offset = 0;
+    while (offset < byte_count) {
+        if (tokenizer->is_done) {
+            return false; // trailing bytes
+        }
+
+        switch (tokenizer->phase) {
+            case PHASE_INITIAL_BYTE: {
+                uint8_t initial_byte = bytes[offset++];
+                uint8_t additional_info = initial_byte & 0x1F;
+                tokenizer->major_type = initial_byte >> 5;
+                tokenizer->argument_bytes_received = 0;
+
+                if (additional_info <= ADDITIONAL_INFO_MAX_INLINE_ARGUMENT) {
+                    tokenizer->argument_byte_count = 1;
+                    tokenizer->argument_bytes[0] = additional_info;
+                    if (!did_read_header(tokenizer, false, callback, context)) {
+                        return false;
+                    }
+                } else if (additional_info == ADDITIONAL_INFO_INDEFINITE_LENGTH) {
+                    tokenizer->argument_byte_count = 0;
+                    if (!did_read_header(tokenizer, true, callback, context)) {
+                        return false;
+                    }
+                } else if (additional_info <= ADDITIONAL_INFO_ONE_BYTE_ARGUMENT + 3) {
+                    // 24, 25, 26, 27 => 1, 2, 4, 8 bytes
+                    tokenizer->argument_byte_count = 1 << (additional_info - ADDITIONAL_INFO_ONE_BYTE_ARGUMENT);
+                    tokenizer->phase = PHASE_ARGUMENT;
+                } else {
+                    return false; // reserved
+                }
+                break;
+            }
+            case PHASE_ARGUMENT: {
+                tokenizer->argument_bytes[tokenizer->argument_bytes_received++] = bytes[offset++];
+                if (tokenizer->argument_bytes_received == tokenizer->argument_byte_count &&
+                    !did_read_header(tokenizer, false, callback, context)) {
+                    return false;
+                }
+                break;
+            }
+            case PHASE_STRING: {
+                uint32_t remaining = tokenizer->string_length - tokenizer->string_bytes_received;
+                uint16_t available = byte_count - offset;
+                uint16_t fragment_length = remaining < available ? (uint16_t) remaining : available;
+
+                cbor_token_t token;
+                init_token(tokenizer, &token, CBOR_TOKEN_STRING_FRAGMENT);
+                token.argument = tokenizer->string_length;
+                token.fragment = bytes + offset;
+                token.fragment_length = fragment_length;
+                token.fragment_offset = tokenizer->string_bytes_received;
+                token.is_last_fragment = fragment_length == remaining;
+
+                offset += fragment_length;
+                tokenizer->string_bytes_received += fragment_length;
+
+                callback(&token, context);
+
+                if (token.is_last_fragment) {
+                    tokenizer->phase = PHASE_INITIAL_BYTE;
+                    did_complete_item(tokenizer, callback, context);
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+#ifndef CBORTOKENIZER_H
+#define CBORTOKENIZER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Deepest nesting of arrays and maps supported, a Radix atom nests
+// `atom -> particleGroups -> group -> particles -> spunParticle -> particle`
+// with some room to spare.
+#define CBOR_TOKENIZER_MAX_DEPTH 8
+
+// Largest header of a CBOR item: initial byte + 8 bytes argument.
+#define CBOR_MAX_ARGUMENT_BYTE_COUNT 8
+
+typedef enum {
+    CBOR_MAJOR_TYPE_UNSIGNED_INTEGER = 0,
+    CBOR_MAJOR_TYPE_NEGATIVE_INTEGER = 1,
+    CBOR_MAJOR_TYPE_BYTE_STRING = 2,
+    CBOR_MAJOR_TYPE_TEXT_STRING = 3,
+    CBOR_MAJOR_TYPE_ARRAY = 4,
+    CBOR_MAJOR_TYPE_MAP = 5,
+    CBOR_MAJOR_TYPE_TAG = 6,
+    CBOR_MAJOR_TYPE_SIMPLE_OR_FLOAT = 7,
+} cbor_major_type_t;
+
+typedef enum {
+    // Integer, simple value or float, `argument` holds its value (raw bits
+    // for floats, `-1 - argument` for negative integers).
+    CBOR_TOKEN_SCALAR,
+    // A part of a byte or text string, `fragment` points into the fed bytes,
+    // `argument` holds the length of the whole string.
+    CBOR_TOKEN_STRING_FRAGMENT,
+    // Start of an array or map, `argument` holds the number of items (pairs
+    // for maps), unless `is_indefinite_length`.
+    CBOR_TOKEN_CONTAINER_START,
+    // End of the array or map started by the last unmatched start token.
+    CBOR_TOKEN_CONTAINER_END,
+} cbor_token_kind_t;
+
+typedef struct {
+    cbor_token_kind_t kind;
+    cbor_major_type_t major_type;
+    // Nesting depth of the token, 0 for the top level item. Start and end
+    // tokens of a container have the depth of the container itself.
+    uint8_t depth;
+    // True if the token is (a part of) a key of the enclosing map.
+    bool is_map_key;
+    bool is_indefinite_length;
+    uint64_t argument;
+
+    // Only used by `CBOR_TOKEN_STRING_FRAGMENT`.
+    const uint8_t *fragment;
+    uint16_t fragment_length;
+    uint32_t fragment_offset; // offset of `fragment` within the string
+    bool is_last_fragment;
+} cbor_token_t;
+
+typedef void (*cbor_token_callback_t)(const cbor_token_t *token, void *context);
+
+typedef struct {
+    uint16_t remaining_items; // only used by definite length containers
+    uint8_t flags;
+} cbor_tokenizer_level_t;
+
+// Resumable, allocation free CBOR tokenizer. Bytes can be fed in chunks split
+// at any position, tokens (even strings) are emitted without copying them.
+typedef struct {
+    uint8_t phase;
+    uint8_t major_type;
+    uint8_t argument_byte_count;
+    uint8_t argument_bytes_received;
+    uint8_t argument_bytes[CBOR_MAX_ARGUMENT_BYTE_COUNT];
+    uint32_t string_length;
+    uint32_t string_bytes_received;
+    uint8_t depth;
+    bool is_done;
+    cbor_tokenizer_level_t levels[CBOR_TOKENIZER_MAX_DEPTH];
+} cbor_tokenizer_t;
+
+void cbor_tokenizer_init(cbor_tokenizer_t *tokenizer);
+
+// Feeds the next `byte_count` bytes, calling `callback` with `context` for
+// every token (or string fragment) parsed. Returns false if the bytes are
+// not well-formed CBOR (or nest deeper than `CBOR_TOKENIZER_MAX_DEPTH`), in
+// which case the tokenizer must not be fed again before `cbor_tokenizer_init`.
+bool cbor_tokenizer_feed(
+    cbor_tokenizer_t *tokenizer,
+    const uint8_t *bytes,
+    uint16_t byte_count,
+    cbor_token_callback_t callback,
+    void *context
+);
+
+// Returns true once one complete top level CBOR item has been parsed.
+bool cbor_tokenizer_is_done(cbor_tokenizer_t *tokenizer);
+
+#endif
@@ -0,0 +1,49 @@
+#include "rri_table.h"
+#include <os.h>
+#include "common_macros.h"
+
+uint8_t *rri_table_assembly_buffer(rri_table_t *table) {
+    return table->rris[table->number_of_rris].rri.bytes;
+}
+
+status_word_t intern_assembled_rri(rri_table_t *table, uint8_t byte_count, uint8_t *output_index) {
+    interned_rri_t *assembled = &table->rris[table->number_of_rris];
+    uint8_t *bytes = assembled->rri.bytes;
+
+    // Expecting `/<address>/<symbol>`, with a non empty address and symbol.
+    uint8_t symbol_offset = 0;
+    for (uint8_t i = 2; i + 1 < byte_count; ++i) {
+        if (bytes[i] == '/') {
+            symbol_offset = i + 1;
+        }
+    }
+    if (bytes[0] != '/' || symbol_offset == 0) {
+        PRINTF("Invalid RRI.\n");
+        return SW_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < table->number_of_rris; ++i) {
+        interned_rri_t *interned = &table->rris[i];
+        if (interned->byte_count == byte_count && os_memcmp(interned->rri.bytes, bytes, byte_count) == 0) {
+            *output_index = i;
+            return SW_OK;
+        }
+    }
+
+    if (table->number_of_rris == MAX_NUMBER_OF_INTERNED_RRIS) {
+        PRINTF("Transfers of more than %d tokens.\n", MAX_NUMBER_OF_INTERNED_RRIS);
+        return SW_CAPACITY_EXCEEDED;
+    }
+    assembled->byte_count = byte_count;
+    assembled->symbol_offset = symbol_offset;
+    *output_index = table->number_of_rris;
+    table->number_of_rris++;
+    return SW_OK;
+}
+
+const char *interned_rri_symbol(rri_table_t *table, uint8_t index, uint8_t *output_length) {
+    assert(index < table->number_of_rris);
+    interned_rri_t *interned = &table->rris[index];
+    *output_length = interned->byte_count - interned->symbol_offset;
+    return (const char *) interned->rri.bytes + interned->symbol_offset;
+}
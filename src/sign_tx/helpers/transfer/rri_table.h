@@ -0,0 +1,40 @@
+#ifndef RRITABLE_H
+#define RRITABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "radix_resource_identifier.h"
+#include "common_macros.h"
+
+// Number of distinct tokens a single transaction may transfer.
+#define MAX_NUMBER_OF_INTERNED_RRIS 3
+
+// A RRI (`/<address>/<symbol>`) stored once per transaction, split up front.
+typedef struct {
+    radix_resource_identifier_t rri;
+    uint8_t byte_count;
+    uint8_t symbol_offset; // index of the first byte of the symbol
+} interned_rri_t;
+
+// Per transaction table of distinct RRIs, transfers refer to a RRI by its
+// index in the table. The slot after the last interned RRI is used to
+// assemble the next RRI in place, hence the extra slot.
+typedef struct {
+    uint8_t number_of_rris;
+    interned_rri_t rris[MAX_NUMBER_OF_INTERNED_RRIS + 1];
+} rri_table_t;
+
+// Buffer of `RADIX_RRI_MAX_BYTE_COUNT` bytes to assemble the next RRI in.
+uint8_t *rri_table_assembly_buffer(rri_table_t *table);
+
+// Interns the `byte_count` bytes RRI assembled in `rri_table_assembly_buffer`,
+// writing its index into `output_index`. Returns `SW_INVALID_PARAM` if it is
+// not a valid RRI, `SW_CAPACITY_EXCEEDED` if it is new and the table is full.
+status_word_t intern_assembled_rri(rri_table_t *table, uint8_t byte_count, uint8_t *output_index);
+
+// Returns the symbol of the RRI at `index`, which is not null terminated,
+// writing its length into `output_length`.
+const char *interned_rri_symbol(rri_table_t *table, uint8_t index, uint8_t *output_length);
+
+#endif
@@ -7,7 +7,7 @@ void print_transfer(transfer_t *transfer) {
     PRINTF("Transfer(\n");
     PRINTF("    Address: "); printRadixAddress(&transfer->address); PRINTF("\n");
     PRINTF("    Amount (dec): "); print_token_amount(&transfer->amount); PRINTF(" E-18\n");
-    PRINTF("    Token symbol: "); print_radix_resource_identifier(&transfer->token_definition_reference); PRINTF("\n");
+    PRINTF("    Token index: %d\n", transfer->token_definition_reference_index);
     PRINTF(")\n");
     PRINTF("$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$\n\n");
 }
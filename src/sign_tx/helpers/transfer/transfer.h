@@ -15,7 +15,7 @@ typedef struct {
     token_amount_t amount;
 
     bool is_token_definition_reference_set;
-    radix_resource_identifier_t token_definition_reference;
+    uint8_t token_definition_reference_index; // index into the `rri_table_t` of the transaction
 } transfer_t;
 
 void print_transfer(transfer_t *transfer);
@@ -0,0 +1,34 @@
+#include "transfer_summary.h"
+#include <os.h>
+#include "common_macros.h"
+
+static bool is_summary_of_transfer(transfer_summary_t *summary, transfer_t *transfer) {
+    return summary->token_definition_reference_index == transfer->token_definition_reference_index &&
+        os_memcmp(summary->address.bytes, transfer->address.bytes, RADIX_ADDRESS_BYTE_COUNT) == 0;
+}
+
+status_word_t add_transfer_to_summaries(transfer_summaries_t *summaries, transfer_t *transfer) {
+    for (uint8_t i = 0; i < summaries->number_of_summaries; ++i) {
+        transfer_summary_t *summary = &summaries->summaries[i];
+        if (!is_summary_of_transfer(summary, transfer)) {
+            continue;
+        }
+        if (!add_uint256(&summary->amount, &transfer->amount)) {
+            PRINTF("Total amount of transfers overflows.\n");
+            return SW_INVALID_PARAM;
+        }
+        return SW_OK;
+    }
+
+    if (summaries->number_of_summaries == MAX_NUMBER_OF_TRANSFER_SUMMARIES) {
+        PRINTF("Transfers to more than %d recipients and tokens.\n", MAX_NUMBER_OF_TRANSFER_SUMMARIES);
+        return SW_CAPACITY_EXCEEDED;
+    }
+
+    transfer_summary_t *summary = &summaries->summaries[summaries->number_of_summaries];
+    os_memcpy(&summary->address, &transfer->address, sizeof(radix_address_t));
+    summary->token_definition_reference_index = transfer->token_definition_reference_index;
+    os_memcpy(&summary->amount, &transfer->amount, sizeof(token_amount_t));
+    summaries->number_of_summaries++;
+    return SW_OK;
+}
@@ -0,0 +1,31 @@
+#ifndef TRANSFERSUMMARY_H
+#define TRANSFERSUMMARY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "transfer.h"
+#include "common_macros.h"
+
+// Number of distinct (recipient, token) pairs a single transaction may send
+// tokens to, which bounds the number of screens the user has to review.
+#define MAX_NUMBER_OF_TRANSFER_SUMMARIES 6
+
+// The total amount of a token sent to a single recipient.
+typedef struct {
+    radix_address_t address;
+    uint8_t token_definition_reference_index;
+    token_amount_t amount;
+} transfer_summary_t;
+
+typedef struct {
+    uint8_t number_of_summaries;
+    transfer_summary_t summaries[MAX_NUMBER_OF_TRANSFER_SUMMARIES];
+} transfer_summaries_t;
+
+// Adds the amount of `transfer` to the summary of its recipient and token,
+// adding a new summary for a pair not seen before. Returns `SW_CAPACITY_EXCEEDED`
+// if there is no room for a new summary and `SW_INVALID_PARAM` if the total
+// amount overflows.
+status_word_t add_transfer_to_summaries(transfer_summaries_t *summaries, transfer_t *transfer);
+
+#endif
@@ -11,5 +11,29 @@ size_t to_string_uint256(
     const size_t outstr_length
 ) {
     assert(outstr_length == UINT256_DEC_STRING_MAX_LENGTH + 1); // +1 for null
-    return convert_byte_buffer_into_decimal(uint256->bytes, 32, outstr);
+    // The conversion divides the bytes in place, so work on a copy.
+    uint256_t dividend;
+    os_memcpy(dividend.bytes, uint256->bytes, RADIX_AMOUNT_BYTE_COUNT);
+    size_t length = convert_byte_buffer_into_decimal(dividend.bytes, RADIX_AMOUNT_BYTE_COUNT, outstr);
+    if (length == 0) {
+        outstr[length++] = '0';
+        outstr[length] = '\0';
+    }
+    return length;
+}
+
+
+bool add_uint256(uint256_t *augend, const uint256_t *addend) {
+    uint256_t sum;
+    uint16_t carry = 0;
+    for (int i = RADIX_AMOUNT_BYTE_COUNT - 1; i >= 0; --i) {
+        carry += augend->bytes[i] + addend->bytes[i];
+        sum.bytes[i] = (uint8_t) carry;
+        carry >>= 8;
+    }
+    if (carry) {
+        return false;
+    }
+    os_memcpy(augend->bytes, sum.bytes, RADIX_AMOUNT_BYTE_COUNT);
+    return true;
 }
@@ -6,6 +6,7 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 // UInt256 max value: 115792089237316195423570985008687907853269984665640564039457584007913129639936
 // which is 78 digits long.
@@ -22,4 +23,8 @@ size_t to_string_uint256(
     char *outstr,
     const size_t outstr_length);
 
+// Adds `addend` to `augend` in place, returns false if the sum overflows, in
+// which case `augend` is left untouched.
+bool add_uint256(uint256_t *augend, const uint256_t *addend);
+
 #endif
\ No newline at end of file
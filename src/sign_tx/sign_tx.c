@@ -2,10 +2,174 @@
 #include <stdbool.h>
 #include <os.h>
 #include <os_io_seproxyhal.h>
+#include <cx.h>
 #include "ui.h"
 #include "common_macros.h"
+#include "global_state.h"
+#include "key_and_signatures.h"
+#include "sha256_hash.h"
+#include "base_conversion.h"
+#include "atom_parser.h"
+#include "transfer_summary.h"
+#include "input_chain.h"
 
-void handle_sign_tx(
+static sign_tx_context_t *ctx = &global.sign_tx_context;
+
+static void did_finish_sign_tx_flow() {
+    size_t tx = derive_sign_move_to_global_buffer(ctx->bip32_path, ctx->hash);
+    io_exchange_with_code(tx > 0 ? SW_OK : SW_INTERNAL_ERROR_ECC, tx);
+    ui_idle();
+}
+
+static void proceed_to_final_signature_confirmation() {
+    display_lines("Sign TX", "Confirm?", did_finish_sign_tx_flow);
+}
+
+static void ask_user_to_confirm_tx_hash(void) {
+    display_value("TX hash", hex_display_source(ctx->hash, HASH256_BYTE_COUNT), proceed_to_final_signature_confirmation);
+}
+
+static status_word_t did_parse_transfer(transfer_t *transfer) {
+    print_transfer(transfer);
+    if (does_address_contain_public_key_bytes(&transfer->address, ctx->signer_public_key)) {
+        PRINTF("Hiding change transfer back to signer.\n");
+        return SW_OK;
+    }
+    return add_transfer_to_summaries(&ctx->transfer_summaries, transfer);
+}
+
+static status_word_t derive_signer_public_key(void) {
+    cx_ecfp_public_key_t public_key;
+    if (!derive_radix_key_pair(
+        ctx->bip32_path,
+        &public_key,
+        NULL  // dont write private key
+    )) {
+        PRINTF("Failed to derive public key of signer.\n");
+        return SW_INTERNAL_ERROR_ECC;
+    }
+    assert(public_key.W_len == PUBLIC_KEY_COMPRESSEED_BYTE_COUNT);
+    os_memcpy(ctx->signer_public_key, public_key.W, PUBLIC_KEY_COMPRESSEED_BYTE_COUNT);
+    return SW_OK;
+}
+
+static transfer_summary_t *summary_under_review(void) {
+    return &ctx->transfer_summaries.summaries[ctx->number_of_summaries_reviewed];
+}
+
+static void ask_user_to_confirm_next_summary_or_tx_hash(void);
+
+static void did_confirm_summary(void) {
+    ctx->number_of_summaries_reviewed++;
+    ask_user_to_confirm_next_summary_or_tx_hash();
+}
+
+static void ask_user_to_confirm_summary_token(void) {
+    uint8_t symbol_length;
+    const char *symbol = interned_rri_symbol(
+        &ctx->atom_parser.rri_table,
+        summary_under_review()->token_definition_reference_index,
+        &symbol_length
+    );
+    display_value("Token", text_display_source(symbol, symbol_length), did_confirm_summary);
+}
+
+static void ask_user_to_confirm_summary_amount(void) {
+    display_value(
+        "Amount E-18",
+        uint256_display_source(&summary_under_review()->amount),
+        ask_user_to_confirm_summary_token
+    );
+}
+
+static void ask_user_to_confirm_summary_address(void) {
+    char title[DISPLAY_OPTIMAL_NUMBER_OF_CHARACTERS_PER_LINE + 1];
+    SPRINTF(
+        title,
+        "To (%d/%d)",
+        ctx->number_of_summaries_reviewed + 1,
+        ctx->transfer_summaries.number_of_summaries
+    );
+    display_value(
+        title,
+        radix_address_display_source(&summary_under_review()->address),
+        ask_user_to_confirm_summary_amount
+    );
+}
+
+// Pages through the transfers, summed up per recipient and token, so the
+// number of screens depends on the number of distinct recipients rather
+// than on the number of particles, followed by the hash of the transaction.
+static void ask_user_to_confirm_next_summary_or_tx_hash(void) {
+    if (ctx->number_of_summaries_reviewed < ctx->transfer_summaries.number_of_summaries) {
+        ask_user_to_confirm_summary_address();
+    } else {
+        ask_user_to_confirm_tx_hash();
+    }
+}
+
+// Feeds the chunk of the serialized transaction straight into the hasher,
+// finalizing the (double SHA256) hash with the last chunk, and into the atom
+// parser, which only copies the fields of the transfers out of the chunk.
+// The transaction itself is never held in RAM.
+static status_word_t process_tx_chunk(uint8_t *chunk, uint16_t chunk_length, bool is_last_chunk) {
+    update_hash_and_maybe_finalize(
+        chunk,
+        chunk_length,
+        is_last_chunk,
+        &ctx->hasher,
+        ctx->hash
+    );
+
+    status_word_t sw = atom_parser_feed(&ctx->atom_parser, chunk, chunk_length, did_parse_transfer);
+    if (sw != SW_OK) {
+        return sw;
+    }
+    if (is_last_chunk && !atom_parser_is_done(&ctx->atom_parser)) {
+        PRINTF("Transaction is not a complete atom.\n");
+        return SW_INVALID_PARAM;
+    }
+    return SW_OK;
+}
+
+// Takes in the next chunk, counting the bytes of the transaction received
+// for `handle_resume_sign_tx`.
+static status_word_t receive_tx_chunk(uint8_t *chunk, uint16_t chunk_length, bool is_last_chunk) {
+    ctx->tx_bytes_received += chunk_length;
+    return process_tx_chunk(chunk, chunk_length, is_last_chunk);
+}
+
+// Acknowledges the chunk just received, from which point on the upload can
+// be resumed, the ack of the first chunk contains the session nonce.
+static void acknowledge_chunk(bool is_first_chunk) {
+    ctx->number_of_chunks_received++;
+    ctx->has_checkpoint = true;
+
+    uint16_t tx = 0;
+    if (is_first_chunk) {
+        os_memcpy(G_io_apdu_buffer, ctx->session_nonce, SIGN_TX_SESSION_NONCE_BYTE_COUNT);
+        tx = SIGN_TX_SESSION_NONCE_BYTE_COUNT;
+    }
+    io_exchange_with_code(SW_OK, tx);
+}
+
+// These are APDU parameters that control the behavior of the signTx command.
+#define P2_ADDRESSES_BETANET 0x02
+
+// handle_sign_tx is the entry point for the signTx command. The input is
+// chained over APDUs (see `input_chain.h`): the BIP32 path (12 bytes, within
+// the first APDU) followed by the serialized transaction (a DSON encoded
+// atom). P2 of the first APDU is a combination of flags: P2_ADDRESSES_BETANET
+// makes addresses of the transfers be shown as betanet ones.
+//
+// Every APDU but the last is acknowledged right away, the response to the
+// first one contains a session nonce (8 bytes) with which an upload
+// interrupted by a reset of the connection can be resumed, see
+// `handle_resume_sign_tx`. Once the last APDU has been received the user is
+// asked to review the transfers, summed up per recipient and token (leaving
+// out change back to the signer), and the hash of the transaction, and the
+// response contains the signature of it.
+status_word_t handle_sign_tx(
         uint8_t p1,
         uint8_t p2,
         uint8_t *data_buffer,
@@ -13,6 +177,86 @@ void handle_sign_tx(
         volatile unsigned int *flags,
         volatile unsigned int *tx
 ) {
-    PRINTF("Function 'handle_sign_tx' is not implemented yet.\n");
-    THROW(SW_FATAL_ERROR_INCORRECT_IMPLEMENTATION);
+    PRINTF("Handle instruction 'SIGN_TX' from host machine.\n");
+    uint16_t expected_bip32_byte_count = BIP32_PATH_LEN;
+
+    bool has_checkpoint = ctx->has_checkpoint;
+    ctx->has_checkpoint = false;
+
+    if (input_chain_is_first_chunk()) {
+        explicit_bzero(ctx, sizeof(sign_tx_context_t));
+
+        uint8_t bip32_path_bytes[BIP32_PATH_LEN];
+        if (!input_chain_read(bip32_path_bytes, expected_bip32_byte_count)) {
+            PRINTF("'data_length' must be at least: %u, but was: %d\n", expected_bip32_byte_count, data_length);
+            return SW_INVALID_PARAM;
+        }
+        status_word_t sw = parse_bip32_path_from_apdu_command(bip32_path_bytes, ctx->bip32_path);
+        if (sw != SW_OK) {
+            return sw;
+        }
+        sw = derive_signer_public_key();
+        if (sw != SW_OK) {
+            return sw;
+        }
+
+        cx_sha256_init(&ctx->hasher);
+        atom_parser_init(&ctx->atom_parser, !(p2 & P2_ADDRESSES_BETANET));
+        cx_rng(ctx->session_nonce, SIGN_TX_SESSION_NONCE_BYTE_COUNT);
+    } else {
+        if (!has_checkpoint) {
+            PRINTF("Not expecting any more chunks.\n");
+            return SW_INVALID_PARAM;
+        }
+    }
+
+    uint8_t *chunk;
+    uint16_t chunk_length = input_chain_read_remaining(&chunk);
+    status_word_t sw = receive_tx_chunk(chunk, chunk_length, input_chain_is_last_chunk());
+    if (sw != SW_OK) {
+        return sw;
+    }
+
+    if (!input_chain_is_last_chunk()) {
+        // Waiting for more chunks.
+        acknowledge_chunk(input_chain_is_first_chunk());
+        return SW_OK;
+    }
+
+    ask_user_to_confirm_next_summary_or_tx_hash();
+
+    *flags |= IO_ASYNCH_REPLY;
+    return SW_OK;
+}
+
+// handle_resume_sign_tx is the entry point for the resumeSignTx command,
+// which continues a signTx upload after the connection has been reset (as
+// long as the app has not been exited). The data is the session nonce (8
+// bytes) returned with the first chunk, the response is the number of
+// chunks received (4 bytes) followed by the number of bytes of the
+// transaction received (4 bytes), after which the host continues the chained
+// input (`P1_CHAIN_CONTINUE`) starting at that byte of the transaction.
+status_word_t handle_resume_sign_tx(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *data_buffer,
+        uint16_t data_length,
+        volatile unsigned int *flags,
+        volatile unsigned int *tx
+) {
+    PRINTF("Handle instruction 'RESUME_SIGN_TX' from host machine.\n");
+    if (data_length != SIGN_TX_SESSION_NONCE_BYTE_COUNT) {
+        PRINTF("'data_length' must be: %u, but was: %d\n", SIGN_TX_SESSION_NONCE_BYTE_COUNT, data_length);
+        return SW_INVALID_PARAM;
+    }
+    if (!ctx->has_checkpoint ||
+        os_memcmp(ctx->session_nonce, data_buffer, SIGN_TX_SESSION_NONCE_BYTE_COUNT) != 0) {
+        PRINTF("No upload to resume with the given nonce.\n");
+        return SW_INVALID_PARAM;
+    }
+
+    WRITE_U4BE(G_io_apdu_buffer, 0, ctx->number_of_chunks_received);
+    WRITE_U4BE(G_io_apdu_buffer, 4, ctx->tx_bytes_received);
+    io_exchange_with_code(SW_OK, 8);
+    return SW_OK;
 }
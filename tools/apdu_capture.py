@@ -0,0 +1,104 @@
+"""Compact binary capture format for APDU sessions with the app.
+
+A capture file starts with the 8 bytes header `b"RDXAPDU" || version`,
+followed by records, all integers big endian:
+
+    command:   u64 timestamp_us | u8 0 | u8 CLA | u8 INS | u8 P1 | u8 P2 | u16 length | payload
+    response:  u64 timestamp_us | u8 1 | u16 length | payload | u16 SW
+
+Timestamps are microseconds since the start of the capture. Every command
+record is followed by its response record, the latency of an exchange is the
+difference of their timestamps.
+"""
+
+import struct
+import time
+from collections import namedtuple
+
+MAGIC = b"RDXAPDU"
+VERSION = 1
+
+DIRECTION_COMMAND = 0
+DIRECTION_RESPONSE = 1
+
+Command = namedtuple("Command", "timestamp_us cla ins p1 p2 payload")
+Response = namedtuple("Response", "timestamp_us payload sw")
+Exchange = namedtuple("Exchange", "command response")
+
+
+class CaptureFormatError(Exception):
+    pass
+
+
+class CaptureWriter:
+    def __init__(self, stream):
+        self._stream = stream
+        self._start = time.perf_counter()
+        stream.write(MAGIC + bytes([VERSION]))
+
+    def _now_us(self):
+        return int((time.perf_counter() - self._start) * 1e6)
+
+    def write_command(self, apdu):
+        cla, ins, p1, p2 = apdu[0], apdu[1], apdu[2], apdu[3]
+        payload = apdu[5:]
+        self._stream.write(struct.pack(">QBBBBBH", self._now_us(), DIRECTION_COMMAND, cla, ins, p1, p2, len(payload)))
+        self._stream.write(payload)
+
+    def write_response(self, payload, sw):
+        self._stream.write(struct.pack(">QBH", self._now_us(), DIRECTION_RESPONSE, len(payload)))
+        self._stream.write(payload)
+        self._stream.write(struct.pack(">H", sw))
+        self._stream.flush()
+
+
+def _read_exactly(stream, count):
+    data = stream.read(count)
+    if len(data) != count:
+        raise CaptureFormatError("truncated capture")
+    return data
+
+
+def read_records(stream):
+    """Yields the `Command` and `Response` records of a capture."""
+    header = stream.read(len(MAGIC) + 1)
+    if header[:len(MAGIC)] != MAGIC:
+        raise CaptureFormatError("not an APDU capture")
+    if header[len(MAGIC)] != VERSION:
+        raise CaptureFormatError("unsupported capture version %d" % header[len(MAGIC)])
+    while True:
+        prefix = stream.read(9)
+        if not prefix:
+            return
+        if len(prefix) != 9:
+            raise CaptureFormatError("truncated capture")
+        timestamp_us, direction = struct.unpack(">QB", prefix)
+        if direction == DIRECTION_COMMAND:
+            cla, ins, p1, p2, length = struct.unpack(">BBBBH", _read_exactly(stream, 6))
+            yield Command(timestamp_us, cla, ins, p1, p2, _read_exactly(stream, length))
+        elif direction == DIRECTION_RESPONSE:
+            (length,) = struct.unpack(">H", _read_exactly(stream, 2))
+            payload = _read_exactly(stream, length)
+            (sw,) = struct.unpack(">H", _read_exactly(stream, 2))
+            yield Response(timestamp_us, payload, sw)
+        else:
+            raise CaptureFormatError("unknown record direction %d" % direction)
+
+
+def read_exchanges(stream):
+    """Yields the command/response pairs of a capture."""
+    command = None
+    for record in read_records(stream):
+        if isinstance(record, Command):
+            if command is not None:
+                raise CaptureFormatError("command without response")
+            command = record
+        else:
+            if command is None:
+                raise CaptureFormatError("response without command")
+            yield Exchange(command, record)
+            command = None
+
+
+def command_apdu(command):
+    return bytes([command.cla, command.ins, command.p1, command.p2, len(command.payload)]) + command.payload
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""End-to-end APDU latency benchmark of the app running under Speculos.
+
+Runs every instruction of the app a number of times against a running
+Speculos (auto-approving review screens), records per-instruction wall
+latencies and writes them as JSON. Two such JSON files can be compared to
+spot regressions between builds:
+
+    speculos.py bin/app.elf --model nanos --display headless &
+    python3 tools/bench_apdu_latency.py --output build-a.json
+    python3 tools/bench_apdu_latency.py --output build-b.json --compare build-a.json
+
+The latencies are wall-clock times measured on the host, from sending a
+command to receiving its response. They include the host, the TCP transport
+and the emulation by Speculos, no instruction or cycle counts of the device
+are recorded. They tell relative changes between builds apart, not the
+timing on a device. Flows requiring review are further dominated by the
+emulated button presses, compare them between runs made on the same host only.
+"""
+
+import argparse
+import json
+import platform
+import statistics
+import subprocess
+import sys
+import time
+
+import apdu_capture
+import speculos_client as sc
+
+# Uncompressed secp256k1 generator point, a valid public key of the other
+# party for the key exchange.
+OTHER_PARTY_PUBLIC_KEY = bytes.fromhex(
+    "04"
+    "79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"
+    "483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8"
+)
+
+HASH = bytes(range(32))
+
+
+def sign_hashes_commands():
+    # 8 hashes chained over two APDUs, the second hash split between them.
+    data = sc.bip32_path() + HASH * 8
+    return [(sc.INS_SIGN_HASHES, sc.P1_CHAIN_FIRST, 0x00, data[:60], False),
+            (sc.INS_SIGN_HASHES, sc.P1_CHAIN_CONTINUE | sc.P1_CHAIN_LAST, 0x00, data[60:], True)]
+
+
+# name -> list of (ins, p1, p2, data, approve)
+BENCHMARKS = {
+    "ping": [(sc.INS_PING, 0, 0, b"ping", False)],
+    "get_version": [(sc.INS_GET_VERSION, 0, 0, b"", False)],
+    "get_public_key": [(sc.INS_GET_PUBLIC_KEY, 0, 0, sc.bip32_path(), False)],
+    "get_public_key_display": [(sc.INS_GET_PUBLIC_KEY, 0x01, 0x01, sc.bip32_path(), True)],
+    "get_public_keys": [(sc.INS_GET_PUBLIC_KEYS, 0, 0, sc.bip32_path() + bytes([7]), False)],
+    "get_extended_public_key": [(sc.INS_GET_EXTENDED_PUBLIC_KEY, 0, 0, bytes(4), False)],
+    "key_exchange": [(sc.INS_KEY_EXCHANGE, 0, 0, sc.bip32_path() + OTHER_PARTY_PUBLIC_KEY, False)],
+    "key_exchange_display": [(sc.INS_KEY_EXCHANGE, 0x01, 0x01, sc.bip32_path() + OTHER_PARTY_PUBLIC_KEY, True)],
+    "sign_hash": [(sc.INS_SIGN_HASH, 0, 0, sc.bip32_path() + HASH, True)],
+    "sign_hashes": sign_hashes_commands(),
+    "sign_hash_multi_path": [(sc.INS_SIGN_HASH_MULTI_PATH, 0, 0,
+                              HASH + bytes([4]) + b"".join(sc.bip32_path(index=i) for i in range(4)),
+                              True)],
+}
+
+
+def summarize(latencies):
+    ordered = sorted(latencies)
+    return {
+        "runs": len(ordered),
+        "min_ms": ordered[0] * 1e3,
+        "median_ms": statistics.median(ordered) * 1e3,
+        "mean_ms": statistics.mean(ordered) * 1e3,
+        "p95_ms": ordered[min(len(ordered) - 1, int(round(0.95 * (len(ordered) - 1))))] * 1e3,
+        "max_ms": ordered[-1] * 1e3,
+    }
+
+
+def run_benchmark(client, commands, runs):
+    latencies = []
+    for _ in range(runs):
+        total = 0.0
+        for ins, p1, p2, data, approve in commands:
+            _, latency = client.exchange(ins, p1, p2, data, approve=approve)
+            total += latency
+        latencies.append(total)
+    return summarize(latencies)
+
+
+def git_revision():
+    try:
+        return subprocess.check_output(["git", "rev-parse", "HEAD"], stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def compare(current, baseline, threshold):
+    """Prints median deltas, returns the names of regressed benchmarks."""
+    regressions = []
+    print("%-28s %12s %12s %9s" % ("benchmark", "base ms", "now ms", "delta"))
+    for name, result in current["results"].items():
+        base = baseline["results"].get(name)
+        if base is None:
+            print("%-28s %12s %12.2f %9s" % (name, "-", result["median_ms"], "new"))
+            continue
+        delta = (result["median_ms"] - base["median_ms"]) / base["median_ms"]
+        marker = ""
+        if delta > threshold:
+            regressions.append(name)
+            marker = "  REGRESSION"
+        print("%-28s %12.2f %12.2f %+8.1f%%%s" % (name, base["median_ms"], result["median_ms"], delta * 100, marker))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--apdu-port", type=int, default=9999)
+    parser.add_argument("--api-port", type=int, default=5000)
+    parser.add_argument("--runs", type=int, default=20, help="runs per non-interactive instruction")
+    parser.add_argument("--interactive-runs", type=int, default=3, help="runs per instruction requiring review")
+    parser.add_argument("--only", action="append", choices=sorted(BENCHMARKS), help="benchmarks to run (default: all)")
+    parser.add_argument("--output", required=True, help="JSON file to write")
+    parser.add_argument("--compare", help="JSON file of a previous run to compare against")
+    parser.add_argument("--capture", help="also record the session as an APDU capture (see apdu_capture.py)")
+    parser.add_argument("--threshold", type=float, default=0.10, help="relative median slowdown counted as regression")
+    args = parser.parse_args()
+
+    results = {}
+    capture_stream = open(args.capture, "wb") if args.capture else None
+    capture = apdu_capture.CaptureWriter(capture_stream) if capture_stream else None
+    with sc.SpeculosClient(args.host, args.apdu_port, args.api_port, capture=capture) as client:
+        for name in args.only or BENCHMARKS:
+            commands = BENCHMARKS[name]
+            interactive = any(command[4] for command in commands)
+            runs = args.interactive_runs if interactive else args.runs
+            results[name] = run_benchmark(client, commands, runs)
+            print("%-28s median %8.2f ms" % (name, results[name]["median_ms"]), file=sys.stderr)
+    if capture_stream:
+        capture_stream.close()
+
+    report = {
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+        "git_revision": git_revision(),
+        "host": platform.node(),
+        "results": results,
+    }
+    with open(args.output, "w") as output:
+        json.dump(report, output, indent=2, sort_keys=True)
+
+    if args.compare:
+        with open(args.compare) as baseline_file:
+            baseline = json.load(baseline_file)
+        if compare(report, baseline, args.threshold):
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Reads the binary trace of an app built with `make TRACE=1` and prints it
+as a timeline, oldest event first.
+
+    python3 tools/decode_trace.py                  # from Speculos
+    python3 tools/decode_trace.py --clear          # and forget the events
+    python3 tools/decode_trace.py --hex 01000000...  # a GET_TRACE response
+
+Ticks are counted from ticker events (every 100 ms) which only arrive while
+the app services events, so durations within a command are approximate,
+the order of the events is exact.
+"""
+
+import argparse
+import struct
+import sys
+
+import speculos_client as sc
+
+TRACE_LAYOUT_VERSION = 1
+P1_CLEAR_AFTER_READING = 0x01
+MS_PER_TICK = 100
+TICK_WRAP = 1 << 16
+
+INSTRUCTION_NAMES = {
+    value: name[len("INS_"):]
+    for name, value in vars(sc).items()
+    if name.startswith("INS_")
+}
+
+STATUS_NAMES = {
+    0x6985: "USER_REJECTED",
+    0x6B00: "FATAL_ERROR_INCORRECT_IMPLEMENTATION",
+    0x6B01: "INVALID_PARAM",
+    0x6B02: "INTERNAL_ERROR_ECC",
+    0x6B03: "CAPACITY_EXCEEDED",
+    0x6D00: "INVALID_INSTRUCTION",
+    0x6E00: "INCORRECT_CLA",
+    0x9000: "OK",
+}
+
+
+def describe_instruction(arg0, arg1):
+    name = INSTRUCTION_NAMES.get(arg0, "0x%02X" % arg0)
+    return "%s p1=0x%02X p2=0x%02X" % (name, arg1 >> 8, arg1 & 0xFF)
+
+
+def describe_status(arg0, arg1):
+    if arg0 & 0xFF00 == sc.SW_MORE_DATA_AVAILABLE:
+        name = "MORE_DATA_AVAILABLE"
+    else:
+        name = STATUS_NAMES.get(arg0, "")
+    return "sw=0x%04X %s length=%d" % (arg0, name, arg1)
+
+
+def describe_display(arg0, arg1):
+    title = struct.pack(">I", arg0).rstrip(b"\0").decode("ascii", "replace")
+    return "%r%s" % (title, " (seeking)" if arg1 else "")
+
+
+# event -> (name, describe(arg0, arg1)), see `trace_event_t` in src/common/trace.h
+EVENTS = {
+    1: ("instruction begin", describe_instruction),
+    2: ("instruction end", describe_status),
+    3: ("derivation begin", lambda a0, a1: "components=%d last=0x%08X" % (a0, a1)),
+    4: ("derivation end", None),
+    5: ("signing begin", lambda a0, a1: "hash length=%d" % a0),
+    6: ("signing end", lambda a0, a1: "result=%d" % a0),
+    7: ("ECDH begin", None),
+    8: ("ECDH end", lambda a0, a1: "secret length=%d" % a0),
+    9: ("UI display", describe_display),
+    10: ("UI approved", None),
+    11: ("UI rejected", None),
+}
+
+
+def decode(data):
+    """Returns `(number_of_events_recorded, [(sequence, tick, event, arg0, arg1)])`
+    with ticks unwrapped."""
+    version, number_of_events_recorded, count = struct.unpack(">BIB", data[:6])
+    if version != TRACE_LAYOUT_VERSION:
+        raise ValueError("Unsupported trace layout version %d" % version)
+    if len(data) != 6 + 11 * count:
+        raise ValueError("Expected %d bytes for %d events, got %d" % (6 + 11 * count, count, len(data)))
+
+    events = []
+    previous_tick = None
+    wraps = 0
+    first_sequence = number_of_events_recorded - count
+    for index in range(count):
+        event, tick, arg0, arg1 = struct.unpack(">BHII", data[6 + 11 * index:6 + 11 * (index + 1)])
+        if previous_tick is not None and tick < previous_tick:
+            wraps += 1
+        previous_tick = tick
+        events.append((first_sequence + index, tick + wraps * TICK_WRAP, event, arg0, arg1))
+    return number_of_events_recorded, events
+
+
+def print_timeline(number_of_events_recorded, events, output=sys.stdout):
+    dropped = number_of_events_recorded - len(events)
+    if dropped:
+        output.write("(%d older events overwritten)\n" % dropped)
+    if not events:
+        output.write("(no events)\n")
+        return
+    first_tick = events[0][1]
+    depth = 0
+    for sequence, tick, event, arg0, arg1 in events:
+        name, describe = EVENTS.get(event, ("event %d" % event, None))
+        if name.endswith("end"):
+            depth = max(depth - 1, 0)
+        details = describe(arg0, arg1) if describe else ""
+        line = "%6d %+8d ms  %s%s %s" % (sequence, (tick - first_tick) * MS_PER_TICK, "  " * depth, name, details)
+        output.write(line.rstrip() + "\n")
+        if name.endswith("begin"):
+            depth += 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--hex", help="decode this GET_TRACE response instead of reading it from Speculos")
+    parser.add_argument("--clear", action="store_true", help="make the app forget the events read")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--apdu-port", type=int, default=9999)
+    parser.add_argument("--api-port", type=int, default=5000)
+    args = parser.parse_args()
+
+    if args.hex:
+        data = bytes.fromhex(args.hex)
+    else:
+        p1 = P1_CLEAR_AFTER_READING if args.clear else 0x00
+        with sc.SpeculosClient(args.host, args.apdu_port, args.api_port) as client:
+            data, _ = client.exchange(sc.INS_GET_TRACE, p1=p1)
+
+    number_of_events_recorded, events = decode(data)
+    print_timeline(number_of_events_recorded, events)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Replays an APDU capture (see `apdu_capture.py`) against the app running
+under Speculos, reporting per-exchange latency deltas against the original
+session and any difference in the responses.
+
+    python3 tools/replay_apdu_capture.py session.rdxapdu
+    python3 tools/replay_apdu_capture.py session.rdxapdu --record replay.rdxapdu
+
+The app answers deterministically (signatures use RFC6979), so responses are
+expected to be identical byte for byte when replayed against a device with the
+same seed. The exception is the session nonce SIGN_TX acknowledges its first
+chunk with, which is random: it is not compared, and captured RESUME_SIGN_TX
+commands are sent with the nonce of the replayed session instead.
+"""
+
+import argparse
+import struct
+import sys
+
+import apdu_capture
+import speculos_client as sc
+
+
+def requires_review(command):
+    """Tells whether the command makes the app show review screens, since
+    those must be approved during replay."""
+    ins, p1, p2 = command.ins, command.p1, command.p2
+    if ins == sc.INS_GET_PUBLIC_KEY:
+        return p1 == 0x01 or p2 in (0x01, 0x02)
+    if ins in (sc.INS_GET_PUBLIC_KEYS, sc.INS_GET_EXTENDED_PUBLIC_KEY):
+        return p1 == 0x01
+    if ins == sc.INS_KEY_EXCHANGE:
+        # Confirmation before the exchange, or display of the shared key.
+        return p1 == 0x01 or p2 == 0x01
+    if ins in (sc.INS_SIGN_HASH, sc.INS_SIGN_HASH_MULTI_PATH):
+        return True
+    if ins in (sc.INS_SIGN_HASHES, sc.INS_SIGN_TX):
+        return bool(p1 & sc.P1_CHAIN_LAST)
+    return False
+
+
+class SessionNonces:
+    """Maps the session nonces of the capture to those of the replay."""
+
+    NONCE_BYTE_COUNT = 8
+
+    def __init__(self):
+        self._live_nonces = {}
+
+    @classmethod
+    def is_nonce_response(cls, command, response):
+        return (command.ins == sc.INS_SIGN_TX
+                and command.p1 & sc.P1_CHAIN_FIRST and not command.p1 & sc.P1_CHAIN_LAST
+                and response.sw == sc.SW_OK and len(response.payload) == cls.NONCE_BYTE_COUNT)
+
+    def remember(self, captured_nonce, live_nonce):
+        self._live_nonces[captured_nonce] = live_nonce
+
+    def substitute(self, command):
+        if command.ins != sc.INS_RESUME_SIGN_TX or command.payload not in self._live_nonces:
+            return command
+        return command._replace(payload=self._live_nonces[command.payload])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--apdu-port", type=int, default=9999)
+    parser.add_argument("--api-port", type=int, default=5000)
+    parser.add_argument("--record", help="also write the replayed session as a capture")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as stream:
+        exchanges = list(apdu_capture.read_exchanges(stream))
+
+    record_stream = open(args.record, "wb") if args.record else None
+    capture = apdu_capture.CaptureWriter(record_stream) if record_stream else None
+    mismatches = 0
+    total_original_us = 0
+    total_replay_us = 0
+    nonces = SessionNonces()
+
+    print("%4s %4s %4s %4s %10s %10s %9s  %s" % ("#", "INS", "P1", "P2", "orig ms", "replay ms", "delta", "result"))
+    with sc.SpeculosClient(args.host, args.apdu_port, args.api_port, capture=capture) as client:
+        for index, (command, response) in enumerate(exchanges):
+            approve = requires_review(command)
+            sent = nonces.substitute(command)
+            data, sw, latency = client.exchange_raw(apdu_capture.command_apdu(sent), approve)
+            is_nonce = SessionNonces.is_nonce_response(command, response)
+            if is_nonce and sw == sc.SW_OK:
+                nonces.remember(response.payload, data)
+
+            original_us = response.timestamp_us - command.timestamp_us
+            replay_us = int(latency * 1e6)
+            total_original_us += original_us
+            total_replay_us += replay_us
+
+            if sw != response.sw:
+                result = "SW 0x%04x != 0x%04x" % (sw, response.sw)
+            elif is_nonce and len(data) == SessionNonces.NONCE_BYTE_COUNT:
+                result = "ok"
+            elif data != response.payload:
+                result = "response differs"
+            else:
+                result = "ok"
+            if result != "ok":
+                mismatches += 1
+
+            delta = (replay_us - original_us) / original_us * 100 if original_us else 0.0
+            print("%4d 0x%02x 0x%02x 0x%02x %10.2f %10.2f %+8.1f%%  %s" % (
+                index, command.ins, command.p1, command.p2, original_us / 1e3, replay_us / 1e3, delta, result))
+
+    if record_stream:
+        record_stream.close()
+
+    print("total: original %.2f ms, replay %.2f ms, %d/%d exchanges differ" % (
+        total_original_us / 1e3, total_replay_us / 1e3, mismatches, len(exchanges)))
+    sys.exit(1 if mismatches else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+"""Minimal client for the Radix Ledger app running under the Speculos emulator.
+
+Talks to the raw APDU TCP port of Speculos (default 9999) and to its REST API
+(default http://127.0.0.1:5000) for pressing buttons. Only depends on the
+Python standard library, so it can run offline next to a local Speculos.
+"""
+
+import json
+import socket
+import struct
+import threading
+import time
+import urllib.request
+
+CLA = 0xAA
+
+INS_PING = 0x00
+INS_GET_VERSION = 0x01
+INS_GET_PUBLIC_KEY = 0x02
+INS_GET_PUBLIC_KEYS = 0x03
+INS_KEY_EXCHANGE = 0x04
+INS_GET_EXTENDED_PUBLIC_KEY = 0x05
+INS_SIGN_HASH = 0x08
+INS_SIGN_HASHES = 0x09
+INS_SIGN_HASH_MULTI_PATH = 0x0A
+INS_SIGN_TX = 0x16
+INS_RESUME_SIGN_TX = 0x17
+INS_GET_STATS = 0x30
+INS_GET_STACK_USAGE = 0x31  # only in builds made with `make STACK_USAGE=1`
+INS_GET_TRACE = 0x32  # only in builds made with `make TRACE=1`
+INS_GET_MORE_DATA = 0xC0
+
+# P1 flags of commands whose input is chained over several APDUs.
+P1_CHAIN_FIRST = 0x01
+P1_CHAIN_CONTINUE = 0x02
+P1_CHAIN_LAST = 0x04
+
+SW_OK = 0x9000
+SW_MORE_DATA_AVAILABLE = 0x6100  # | number of bytes left, capped to 0xFF
+
+
+class ApduError(Exception):
+    def __init__(self, sw):
+        super().__init__("APDU failed with status word 0x%04x" % sw)
+        self.sw = sw
+
+
+def apdu(ins, p1=0, p2=0, data=b""):
+    """Serializes a command APDU for this app."""
+    if len(data) > 255:
+        raise ValueError("APDU payload too long: %d" % len(data))
+    return bytes([CLA, ins, p1, p2, len(data)]) + bytes(data)
+
+
+def bip32_path(account=0, change=0, index=0):
+    """The 12 bytes `account || change || address index` sent for a path."""
+    return struct.pack(">III", account, change, index)
+
+
+class SpeculosClient:
+    def __init__(self, host="127.0.0.1", apdu_port=9999, api_port=5000, timeout=60.0, capture=None):
+        """`capture` is an optional `apdu_capture.CaptureWriter` recording
+        every exchange."""
+        self._api = "http://%s:%d" % (host, api_port)
+        self._capture = capture
+        self._socket = socket.create_connection((host, apdu_port), timeout=timeout)
+
+    def close(self):
+        self._socket.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def _receive_exactly(self, count):
+        data = b""
+        while len(data) < count:
+            chunk = self._socket.recv(count - len(data))
+            if not chunk:
+                raise ConnectionError("Speculos closed the APDU socket")
+            data += chunk
+        return data
+
+    def send_raw(self, command):
+        """Sends `command` without waiting for the response."""
+        self._socket.sendall(struct.pack(">I", len(command)) + command)
+
+    def receive_raw(self):
+        """Returns `(data, sw)` of the next response."""
+        (length,) = struct.unpack(">I", self._receive_exactly(4))
+        response = self._receive_exactly(length + 2)
+        return response[:-2], struct.unpack(">H", response[-2:])[0]
+
+    def exchange_raw(self, command, approve=False):
+        """Exchanges a command APDU, returning `(data, sw, latency_seconds)`.
+
+        If `approve` is set the review screens of the app are walked through
+        and approved while waiting for the response. The latency is host wall
+        time, including the transport and the emulation.
+        """
+        if self._capture:
+            self._capture.write_command(command)
+        start = time.perf_counter()
+        self.send_raw(command)
+        if approve:
+            done = threading.Event()
+            presser = threading.Thread(target=self._approve_until, args=(done,), daemon=True)
+            presser.start()
+            try:
+                data, sw = self.receive_raw()
+            finally:
+                done.set()
+                presser.join()
+        else:
+            data, sw = self.receive_raw()
+        latency = time.perf_counter() - start
+        if self._capture:
+            self._capture.write_response(data, sw)
+        return data, sw, latency
+
+    def exchange(self, ins, p1=0, p2=0, data=b"", approve=False):
+        """Like `exchange_raw` but raises `ApduError` unless the status is OK.
+
+        Responses chained over several APDUs are read with GET_MORE_DATA and
+        concatenated, the latency covers all of them.
+        """
+        response, sw, latency = self.exchange_raw(apdu(ins, p1, p2, data), approve)
+        while sw & 0xFF00 == SW_MORE_DATA_AVAILABLE:
+            more, sw, more_latency = self.exchange_raw(apdu(INS_GET_MORE_DATA))
+            response += more
+            latency += more_latency
+        if sw != SW_OK:
+            raise ApduError(sw)
+        return response, latency
+
+    def press(self, button):
+        """Presses and releases `left`, `right` or `both`."""
+        request = urllib.request.Request(
+            "%s/button/%s" % (self._api, button),
+            data=json.dumps({"action": "press-and-release"}).encode(),
+            headers={"Content-Type": "application/json"},
+            method="POST",
+        )
+        urllib.request.urlopen(request).read()
+
+    def _approve_until(self, done):
+        # Value screens of the app are left with both buttons, approval
+        # screens are approved with the right button. Pressing both buttons on
+        # an approval screen, or right on a value screen, is harmless.
+        while not done.is_set():
+            self.press("both")
+            if done.wait(0.05):
+                break
+            self.press("right")
+            done.wait(0.05)
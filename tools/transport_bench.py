@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Transport bandwidth benchmark using the loopback mode of ping.
+
+Sweeps request and response payload sizes, reporting the round trip latency
+and the effective payload throughput of each combination, to size chunks
+and batch commands per transport:
+
+    python3 tools/transport_bench.py                  # Speculos (TCP)
+    python3 tools/transport_bench.py --device         # USB HID, needs ledgerblue
+    python3 tools/transport_bench.py --output hid.json
+
+Speculos forwards APDUs over TCP, so only runs against a device measure the
+USB HID transport (64 bytes per HID report).
+"""
+
+import argparse
+import json
+import statistics
+import sys
+import time
+
+import speculos_client as sc
+
+P1_LOOPBACK_ECHO = 0x01
+P1_LOOPBACK_SYNTHESIZE = 0x02
+
+DEFAULT_SIZES = [0, 16, 32, 59, 64, 123, 128, 187, 192, 255]
+
+
+class SpeculosTransport:
+    def __init__(self, args):
+        self._client = sc.SpeculosClient(args.host, args.apdu_port, args.api_port)
+
+    def exchange(self, command):
+        data, sw, latency = self._client.exchange_raw(command)
+        if sw != sc.SW_OK:
+            raise sc.ApduError(sw)
+        return data, latency
+
+    def close(self):
+        self._client.close()
+
+
+class DeviceTransport:
+    def __init__(self, args):
+        from ledgerblue.comm import getDongle
+        self._dongle = getDongle(False)
+
+    def exchange(self, command):
+        start = time.perf_counter()
+        data = bytes(self._dongle.exchange(command))
+        return data, time.perf_counter() - start
+
+    def close(self):
+        self._dongle.close()
+
+
+def measure(transport, request_size, response_size, runs):
+    p1 = P1_LOOPBACK_ECHO if request_size else P1_LOOPBACK_SYNTHESIZE
+    payload = bytes(i & 0xFF for i in range(request_size))
+    command = sc.apdu(sc.INS_PING, p1, response_size, payload)
+    latencies = []
+    for _ in range(runs):
+        data, latency = transport.exchange(command)
+        if len(data) != response_size:
+            raise RuntimeError("Expected %d bytes, got %d" % (response_size, len(data)))
+        latencies.append(latency)
+    median = statistics.median(latencies)
+    return {
+        "request_bytes": request_size,
+        "response_bytes": response_size,
+        "runs": runs,
+        "min_ms": min(latencies) * 1e3,
+        "median_ms": median * 1e3,
+        "bytes_per_second": (request_size + response_size) / median if median else None,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--device", action="store_true", help="use a device over USB instead of Speculos")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--apdu-port", type=int, default=9999)
+    parser.add_argument("--api-port", type=int, default=5000)
+    parser.add_argument("--runs", type=int, default=20, help="runs per size combination")
+    parser.add_argument("--sizes", type=lambda s: [int(size) for size in s.split(",")], default=DEFAULT_SIZES,
+                        help="comma separated payload sizes (0-255) swept for requests and responses")
+    parser.add_argument("--output", help="JSON file to write the results to")
+    args = parser.parse_args()
+
+    if any(size < 0 or size > 255 for size in args.sizes):
+        parser.error("sizes must be between 0 and 255")
+
+    transport = DeviceTransport(args) if args.device else SpeculosTransport(args)
+    results = []
+    try:
+        print("%8s %8s %10s %10s %12s" % ("request", "response", "min ms", "median ms", "bytes/s"))
+        for request_size in args.sizes:
+            for response_size in args.sizes:
+                result = measure(transport, request_size, response_size, args.runs)
+                results.append(result)
+                print("%8d %8d %10.2f %10.2f %12.0f" % (
+                    request_size, response_size, result["min_ms"], result["median_ms"],
+                    result["bytes_per_second"] or 0))
+    finally:
+        transport.close()
+
+    if args.output:
+        report = {
+            "timestamp": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+            "transport": "usb" if args.device else "speculos",
+            "results": results,
+        }
+        with open(args.output, "w") as output:
+            json.dump(report, output, indent=2, sort_keys=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())